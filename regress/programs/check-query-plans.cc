@@ -0,0 +1,178 @@
+/*
+  check-query-plans.cc -- check that parameterized lookups use indices
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "compat.h"
+
+#include <ProgramName.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CkmameDB.h"
+#include "DB.h"
+#include "Exception.h"
+#include "RomDB.h"
+#include "globals.h"
+
+enum DBType { DBTYPE_INVALID = -1, DBTYPE_CKMAMEDB, DBTYPE_ROMDB };
+
+class ParameterizedStatement {
+  public:
+    int id;
+    std::string name;
+    bool uses_size;
+};
+
+static const std::vector<ParameterizedStatement> ckmamedb_statements = {
+    {CkmameDB::QUERY_FIND_FILE, "QUERY_FIND_FILE", true}};
+static const std::vector<ParameterizedStatement> romdb_statements = {{RomDB::QUERY_FILE_FBH, "QUERY_FILE_FBH", false}};
+
+static bool check_statement(DB* db, const ParameterizedStatement& statement);
+static std::string variant_name(int hash_types, bool have_size);
+
+std::vector<Commandline::Option> check_query_plans_options = {
+    Commandline::Option("type", 't', "type", "specify type of database: mamedb (default) or ckmamedb")};
+
+#define PROGRAM_NAME "check-query-plans"
+
+int main(int argc, char* argv[]) {
+    DBType type = DBTYPE_ROMDB;
+
+    const char* header = PROGRAM_NAME " by Dieter Baron and Thomas Klausner";
+    const char* footer = "Report bugs to " PACKAGE_BUGREPORT ".";
+    const char* version =
+        PROGRAM_NAME " (" PACKAGE " " VERSION ")\nCopyright (C) 2026 Dieter Baron and Thomas Klausner\n" PACKAGE
+        " " VERSION "\n" PACKAGE " comes with ABSOLUTELY NO WARRANTY, to the extent permitted by law.\n";
+
+    auto commandline = Commandline(check_query_plans_options, "db-file", header, footer, version);
+
+    auto arguments = commandline.parse(argc, argv);
+
+    for (const auto& option : arguments.options) {
+        if (option.name == "type") {
+            if (option.argument == "ckmamedb") {
+                type = DBTYPE_CKMAMEDB;
+            }
+            else if (option.argument == "mamedb") {
+                type = DBTYPE_ROMDB;
+            }
+            else {
+                std::cerr << ProgramName::get() << ": unknown db type '" << option.argument << "'" << std::endl;
+                exit(1);
+            }
+        }
+    }
+
+    if (arguments.arguments.size() != 1) {
+        commandline.usage(false, std::cerr);
+        exit(1);
+    }
+
+    auto db_fname = arguments.arguments[0];
+    auto ok = true;
+
+    try {
+        std::unique_ptr<DB> db;
+        const std::vector<ParameterizedStatement>* statements;
+
+        if (type == DBTYPE_CKMAMEDB) {
+            db = std::make_unique<CkmameDB>(db_fname, ".", FILE_NOWHERE);
+            statements = &ckmamedb_statements;
+        }
+        else {
+            db = std::make_unique<RomDB>(db_fname, DBH_READ);
+            statements = &romdb_statements;
+        }
+
+        for (const auto& statement : *statements) {
+            ok = check_statement(db.get(), statement) && ok;
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << ProgramName::get() << ": can't check '" << db_fname << "': " << e.what() << std::endl;
+        exit(1);
+    }
+
+    exit(ok ? 0 : 1);
+}
+
+
+/*
+  Check all variants of statement that are used for lookups, i.e. with at least one hash or the size, and report
+  variants that scan a whole table.
+*/
+static bool check_statement(DB* db, const ParameterizedStatement& statement) {
+    auto ok = true;
+
+    for (auto have_size = 0; have_size <= (statement.uses_size ? 1 : 0); have_size++) {
+        for (auto hash_types = 0; hash_types <= Hashes::TYPE_ALL; hash_types++) {
+            if (hash_types == 0 && !have_size) {
+                continue;
+            }
+
+            Hashes hashes;
+            hashes.add_types(hash_types);
+
+            for (const auto& step : db->explain_query_plan(statement.id, hashes, have_size)) {
+                if (step.starts_with("SCAN")) {
+                    std::cout << statement.name << " (" << variant_name(hash_types, have_size) << "): " << step
+                              << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    return ok;
+}
+
+
+static std::string variant_name(int hash_types, bool have_size) {
+    std::string name;
+
+    if (have_size) {
+        name = "size";
+    }
+    for (auto type = 1; type <= Hashes::TYPE_MAX; type <<= 1) {
+        if (hash_types & type) {
+            if (!name.empty()) {
+                name += ", ";
+            }
+            name += Hashes::type_name(type);
+        }
+    }
+
+    return name;
+}
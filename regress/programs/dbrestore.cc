@@ -48,10 +48,11 @@
 #include "Exception.h"
 #include "RomDB.h"
 #include "SharedFile.h"
+#include "StatusDB.h"
 #include "globals.h"
 #include "util.h"
 
-enum DBType { DBTYPE_INVALID = -1, DBTYPE_CKMAMEDB, DBTYPE_ROMDB };
+enum DBType { DBTYPE_INVALID = -1, DBTYPE_CKMAMEDB, DBTYPE_ROMDB, DBTYPE_STATUSDB };
 
 static int column_type(const std::string& name);
 static int db_format(DBType type);
@@ -66,7 +67,7 @@ static std::vector<std::string> split(const std::string& string, const std::stri
 std::vector<Commandline::Option> dbrestore_options = {
     Commandline::Option("db-version", "version", "specify DB schema version"),
     Commandline::Option("sql", "file", "take SQL schema from FILE"),
-    Commandline::Option("type", 't', "type", "specify type of database: mamedb (default) or ckmamedb)")};
+    Commandline::Option("type", 't', "type", "specify type of database: mamedb (default), ckmamedb, or statusdb")};
 
 #define PROGRAM_NAME "dbrestore"
 
@@ -162,6 +163,10 @@ int main(int argc, char* argv[]) {
                 db = std::make_unique<RomDB>(db_fname, DBH_TRUNCATE | DBH_WRITE | DBH_CREATE);
                 break;
 
+            case DBTYPE_STATUSDB:
+                db = std::make_unique<StatusDB>(db_fname, DBH_TRUNCATE | DBH_WRITE | DBH_CREATE);
+                break;
+
             default:
                 throw Exception("can't happen");
             }
@@ -189,7 +194,8 @@ int main(int argc, char* argv[]) {
 
 
 static const std::unordered_map<std::string, int> column_types = {
-    {"binary", SQLITE_BLOB}, {"blob", SQLITE_BLOB}, {"integer", SQLITE_INTEGER}, {"text", SQLITE_TEXT}};
+    {"binary", SQLITE_BLOB}, {"blob", SQLITE_BLOB}, {"int", SQLITE_INTEGER}, {"integer", SQLITE_INTEGER},
+    {"text", SQLITE_TEXT}};
 
 static int column_type(const std::string& name) {
     auto it = column_types.find(name);
@@ -205,6 +211,7 @@ static int column_type(const std::string& name) {
 static const std::unordered_map<std::string, DBType> db_types = {
     {"ckmamedb", DBTYPE_CKMAMEDB},
     {"mamedb", DBTYPE_ROMDB},
+    {"statusdb", DBTYPE_STATUSDB},
 };
 
 static DBType db_type(const std::string& name) {
@@ -225,6 +232,9 @@ static int db_format(DBType type) {
     case DBTYPE_ROMDB:
         return RomDB::format.id;
 
+    case DBTYPE_STATUSDB:
+        return StatusDB::format.id;
+
     default:
         return -1;
     }
@@ -0,0 +1,125 @@
+/*
+  detector-hashes.cc -- compute hashes of file as matched by detectors
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "config.h"
+
+#include <ProgramName.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Commandline.h"
+#include "Detector.h"
+
+std::vector<Commandline::Option> detector_hashes_options = {
+    Commandline::Option("block-size", 'b', "size", "pass file data in blocks of size bytes")};
+
+#define PROGRAM_NAME "detector-hashes"
+
+int main(int argc, char* argv[]) {
+    size_t block_size = 0;
+
+    const char* header = PROGRAM_NAME " by Dieter Baron and Thomas Klausner";
+    const char* footer = "Report bugs to " PACKAGE_BUGREPORT ".";
+    const char* version =
+        PROGRAM_NAME " (" PACKAGE " " VERSION ")\nCopyright (C) 2026 Dieter Baron and Thomas Klausner\n" PACKAGE
+        " " VERSION "\n" PACKAGE " comes with ABSOLUTELY NO WARRANTY, to the extent permitted by law.\n";
+
+    auto commandline = Commandline(detector_hashes_options, "file detector-file ...", header, footer, version);
+
+    auto arguments = commandline.parse(argc, argv);
+
+    for (const auto& option : arguments.options) {
+        if (option.name == "block-size") {
+            block_size = std::stoul(option.argument);
+        }
+    }
+
+    if (arguments.arguments.size() < 2) {
+        commandline.usage(false, std::cerr);
+        exit(1);
+    }
+
+#if defined(HAVE_LIBXML2)
+    const auto& file_name = arguments.arguments[0];
+    auto file = std::ifstream(file_name, std::ios::binary);
+    if (!file) {
+        std::cerr << ProgramName::get() << ": can't open '" << file_name << "'" << std::endl;
+        exit(1);
+    }
+    auto data = std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    std::vector<DetectorPtr> detectors;
+    for (size_t i = 1; i < arguments.arguments.size(); i++) {
+        auto detector = Detector::parse(arguments.arguments[i]);
+        if (!detector) {
+            exit(1);
+        }
+        detectors.push_back(detector);
+    }
+
+    // All detectors run on the same data, like when computing hashes of files in archives.
+    auto execution = Detector::Execution(data.size());
+    std::vector<size_t> indices;
+    for (const auto& detector : detectors) {
+        indices.push_back(execution.add(*detector));
+    }
+
+    if (block_size == 0) {
+        block_size = data.size();
+    }
+    for (size_t offset = 0; offset < data.size(); offset += block_size) {
+        execution.update(data.data() + offset, std::min(block_size, data.size() - offset));
+    }
+
+    for (size_t i = 0; i < detectors.size(); i++) {
+        auto hashes = execution.end(indices[i]);
+        std::cout << detectors[i]->name << ": ";
+        if (hashes.empty()) {
+            std::cout << "no match" << std::endl;
+        }
+        else {
+            std::cout << "size " << hashes.size << " crc " << hashes.to_string(Hashes::TYPE_CRC) << std::endl;
+        }
+    }
+
+    exit(0);
+#else
+    std::cerr << ProgramName::get() << ": built without XML support, detectors not available" << std::endl;
+    exit(1);
+#endif
+}
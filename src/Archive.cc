@@ -63,6 +63,7 @@
 // #define DEBUG_LC
 
 bool Archive::read_only_mode = false;
+uint64_t Archive::modifying_commits = 0;
 
 std::unordered_map<ArchiveContents::TypeAndName, ArchiveContentsPtr> ArchiveContents::archive_by_name;
 
@@ -520,7 +521,7 @@ void Archive::merge_files(const std::vector<File>& files_cache) {
             set_cache_changed(FILES);
         }
 
-        if (want_crc() && !file.hashes.has_type(Hashes::TYPE_CRC)) {
+        if (want_crc() && !file.hashes.has_type(Hashes::TYPE_CRC) && (contents->flags & ARCHIVE_FL_DEFER_HASHES) == 0) {
             if (!file_ensure_hashes(i, Hashes::TYPE_ALL)) {
                 file.broken = true;
                 if (it == files_cache.cend() || !(*it).broken) {
@@ -604,14 +605,28 @@ std::optional<size_t> ArchiveContents::file_index_by_name(const std::string& fil
 }
 
 bool Archive::compute_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors) {
+    auto progress = Progress::Message("computing hashes in '" + name + "'");
+
+    return compute_missing_detector_hashes(detectors, true);
+}
+
+
+bool Archive::compute_missing_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors) {
+    return compute_missing_detector_hashes(detectors, false);
+}
+
+
+bool Archive::compute_missing_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors,
+                                              bool update_progress) {
     auto got_new_hashes = false;
 
-    Progress::push_message("computing hashes in '" + name + "'");
     for (size_t index = 0; index < files.size(); index++) {
         auto& file = files[index];
         std::unordered_map<size_t, DetectorPtr> missing_detectors;
 
-        Progress::update();
+        if (update_progress) {
+            Progress::update();
+        }
 
         for (const auto& pair : detectors) {
             if (file.detector_hashes.find(pair.first) == file.detector_hashes.end()) {
@@ -631,7 +646,6 @@ bool Archive::compute_detector_hashes(const std::unordered_map<size_t, DetectorP
     if (got_new_hashes) {
         set_cache_changed(HASHES_ONLY);
     }
-    Progress::pop_message();
 
     return got_new_hashes;
 }
@@ -644,15 +658,13 @@ bool Archive::compute_detector_hashes(size_t index, const std::unordered_map<siz
         return false;
     }
 
-    auto data = std::vector<uint8_t>(file.get_size(0));
-
     try {
         auto source = get_source(index);
         if (!source) {
             throw Exception("can't open: {}", strerror(errno));
         }
         source->open();
-        source->read(data.data(), data.size());
+        return Detector::compute_hashes(source.get(), &file, db->detectors, &changes[index].updated_hashes);
     }
     catch (std::exception& e) {
         output.error("{}: {}: can't compute hashes: {}", name, file.name, e.what());
@@ -660,8 +672,6 @@ bool Archive::compute_detector_hashes(size_t index, const std::unordered_map<siz
 
         return false;
     }
-
-    return Detector::compute_hashes(data, &file, db->detectors, &changes[index].updated_hashes);
 }
 
 
@@ -59,6 +59,8 @@ typedef std::shared_ptr<ArchiveContents> ArchiveContentsPtr;
 #define ARCHIVE_FL_CREATE 0x00100
 #define ARCHIVE_FL_RDONLY 0x01000
 #define ARCHIVE_FL_TOP_LEVEL_ONLY 0x02000
+// Don't compute missing hashes when opening, caller uses file_ensure_hashes.
+#define ARCHIVE_FL_DEFER_HASHES 0x04000
 
 #define ARCHIVE_FL_HASHTYPES_MASK 0x000ff
 #define ARCHIVE_FL_MASK 0x0ff00
@@ -142,6 +144,8 @@ class Archive {
     static ArchivePtr open(const ArchiveContentsPtr& contents, int flags = 0);
 
     static bool read_only_mode;
+    /// Number of commits that changed files on disk, used to tell whether fixing a game touched any files.
+    static uint64_t modifying_commits;
 
     explicit Archive(ArchiveContentsPtr contents_);
     virtual ~Archive() = default;
@@ -150,6 +154,13 @@ class Archive {
     bool commit();
     bool compare_size_hashes(size_t index, size_t detector_id, const FileData* rom);
     bool compute_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors);
+    /**
+     * Compute missing detector hashes for all files, without progress reporting, so it can be called from any thread
+     * as long as no other thread uses this archive.
+     *
+     * @return Whether new hashes were computed.
+     */
+    bool compute_missing_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors);
     void move_broken_archive();
     bool file_add_empty(const std::string& filename);
     int file_compare_hashes(uint64_t idx, const Hashes* h);
@@ -209,6 +220,8 @@ class Archive {
 
   private:
     bool compute_detector_hashes(size_t index, const std::unordered_map<size_t, DetectorPtr>& detectors);
+    bool compute_missing_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors,
+                                         bool update_progress);
 };
 
 #endif //* HAD_ARCHIVE_H
@@ -41,19 +41,6 @@
 #include "StatusDB.h"
 #include "util.h"
 
-namespace std {
-template <> struct hash<std::vector<uint8_t>> {
-    std::size_t operator()(const std::vector<unsigned char>& vec) const {
-        std::size_t hash = 0;
-        for (auto& byte : vec) {
-            hash ^= std::hash<uint8_t>{}(byte) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-        }
-        return hash;
-    }
-};
-} // namespace std
-
-
 class CkStatus : public Command {
   public:
     CkStatus();
@@ -65,36 +52,6 @@ class CkStatus : public Command {
   private:
     enum Special { ALL_MISSING, CHANGES, CORRECT, DELETE_RUN, LIST_MIA, MISSING, RUNS, SUMMARY };
 
-    class RunDiff {
-      public:
-        RunDiff(int run_from, int run_to) : run_from(run_from), run_to(run_to) {}
-
-        void compute();
-
-      private:
-        class GameChecksum {
-          public:
-            std::string name;
-            std::vector<uint8_t> checksum;
-
-            bool operator<(const GameChecksum& other) const { return string_less_case_insensitive(name, other.name); }
-        };
-
-        class GameDiff {
-          public:
-            std::optional<StatusDB::GameInfo> old_info;
-            std::optional<StatusDB::GameInfo> new_info;
-        };
-
-        static bool is_complete(GameStatus status) { return status == GS_CORRECT || status == GS_CORRECT_MIA; }
-        void insert_run(bool old);
-
-        int run_from;
-        int run_to;
-        std::vector<GameChecksum> games;
-        std::unordered_map<std::vector<uint8_t>, GameDiff> diffs;
-    };
-
     std::set<Special> specials;
     std::optional<int> run_id;
     std::optional<int> run_from;
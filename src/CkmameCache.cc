@@ -415,6 +415,10 @@ std::vector<CkmameDB::FindResult> CkmameCache::find_file(filetype_t filetype, si
         }
     }
 
+    // Prefer files that match without detector, in case detector hashes have already been computed.
+    std::stable_partition(results.begin(), results.end(),
+                          [](const CkmameDB::FindResult& result) { return result.detector_id == 0; });
+
     // std::cout << "searching for file '" << rom.name << "', got " << results.size() << " results" << std::endl;
     return results;
 }
@@ -439,3 +443,17 @@ bool CkmameCache::compute_all_detector_hashes(bool needed_only,
 
     return got_new_hashes;
 }
+
+
+void CkmameCache::precompute_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors) {
+    if (detectors.empty()) {
+        return;
+    }
+
+    // The ROM set is left to compute_all_detector_hashes(), which is called when a file is not found otherwise.
+    for (auto& cache_directory : cache_directories) {
+        if (cache_directory.db && cache_directory.where != FILE_ROMSET) {
+            cache_directory.db->compute_detector_hashes(detectors);
+        }
+    }
+}
@@ -54,6 +54,8 @@ class CkmameCache {
 
     std::vector<CkmameDB::FindResult> find_file(filetype_t filetype, size_t detector_id, const FileData& rom);
     bool compute_all_detector_hashes(bool needed_only, const std::unordered_map<size_t, DetectorPtr>& detectors);
+    /// Compute missing detector hashes in the needed and extra directories before checking games.
+    void precompute_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors);
 
     void used(Archive* a, size_t idx);
 
@@ -42,8 +42,12 @@
 #include "Exception.h"
 #include "Progress.h"
 #include "fix.h"
+#include "parallel.h"
 #include "util.h"
 
+// Number of archives whose detector hashes are computed before writing them to the database.
+static const size_t detector_hashes_batch_size = 128;
+
 const std::string CkmameDB::db_name = ".ckmame.db";
 
 const DB::DBFormat CkmameDB::format = {
@@ -110,7 +114,9 @@ alter table file add column sha256 binary;\n\
 create index file_sha256 on file (sha256);\n\
     "}
 
-    }};
+    },
+    // No write-ahead log: its files would show up in the directory the database describes.
+    {false, 8 * 1024, 64 * 1024 * 1024}};
 
 
 std::unordered_map<CkmameDB::Statement, std::string> CkmameDB::queries = {
@@ -527,17 +533,67 @@ bool CkmameDB::compute_detector_hashes(const std::unordered_map<size_t, Detector
         return false;
     }
 
-    auto got_new_hashes = false;
+    std::vector<ArchiveContentsPtr> pending;
 
     for (const auto& location : list_archives()) {
         auto contents = ArchiveContents::by_name(location.filetype, directory + "/" + location.name);
         if (contents == nullptr || contents->has_all_detector_hashes(detectors)) {
             continue;
         }
-        auto archive = Archive::open(contents);
-        if (archive->compute_detector_hashes(detectors)) {
-            got_new_hashes = true;
+        pending.push_back(contents);
+    }
+
+    auto got_new_hashes = false;
+
+    // Archives are processed in parallel, in batches. The results of each batch are written in one transaction, so
+    // an interrupted run keeps them and the next run continues with the remaining archives.
+    for (size_t batch_start = 0; batch_start < pending.size(); batch_start += detector_hashes_batch_size) {
+        auto batch_end = std::min(batch_start + detector_hashes_batch_size, pending.size());
+        auto progress = Progress::Message("computing detector hashes in '{}' ({}/{} archives)", directory, batch_start,
+                                          pending.size());
+
+        std::vector<ArchivePtr> archives;
+        for (auto index = batch_start; index < batch_end; index++) {
+            archives.push_back(Archive::open(pending[index]));
+        }
+
+        std::vector<uint8_t> changed(archives.size());
+        std::vector<std::vector<Output::CapturedMessage>> messages(archives.size());
+        try {
+            parallel_for(archives.size(), [&archives, &changed, &messages, &detectors](size_t index) {
+                output.start_capture();
+                try {
+                    changed[index] = archives[index] && archives[index]->compute_missing_detector_hashes(detectors);
+                }
+                catch (...) {
+                    messages[index] = output.end_capture();
+                    throw;
+                }
+                messages[index] = output.end_capture();
+            });
+        }
+        catch (...) {
+            for (const auto& archive_messages : messages) {
+                output.print_captured(archive_messages);
+            }
+            throw;
+        }
+
+        begin_transaction();
+        try {
+            for (size_t index = 0; index < archives.size(); index++) {
+                output.print_captured(messages[index]);
+                if (changed[index]) {
+                    got_new_hashes = true;
+                    archives[index]->commit();
+                }
+            }
+        }
+        catch (...) {
+            rollback_transaction();
+            throw;
         }
+        commit_transaction();
     }
 
     return got_new_hashes;
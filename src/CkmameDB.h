@@ -99,6 +99,11 @@ class CkmameDB : public DB {
     void insert_file_detector_hashes(int archive_id, size_t file_id, size_t detector_id, const Hashes& hashes);
 
     void find_file(filetype_t filetype, size_t detector_id, const FileData& file, std::vector<FindResult>& results);
+    /**
+     * Compute missing detector hashes for all archives in the directory, in parallel, and write them to the database.
+     *
+     * @return Whether new hashes were computed.
+     */
     bool compute_detector_hashes(const std::unordered_map<size_t, DetectorPtr>& detectors);
     void refresh();
 
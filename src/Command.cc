@@ -42,6 +42,9 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "globals.h"
 
 #include "ProgramName.h"
+#if defined(HAVE_LIBXML2)
+#include "XmlProcessor.h"
+#endif
 
 Command::Command(std::string name, std::string arguments, std::vector<Commandline::Option> options,
                  std::unordered_set<std::string> used_variables)
@@ -53,6 +56,9 @@ Command::Command(std::string name, std::string arguments, std::vector<Commandlin
 
 int Command::run(int argc, char* const* argv) {
     ProgramName::set(argv[0]);
+#if defined(HAVE_LIBXML2)
+    XmlProcessor::init();
+#endif
 
     auto command_name = name;
     auto version = std::string(PACKAGE " " VERSION);
@@ -39,7 +39,10 @@
 #include <iostream>
 #include <set>
 
+#include <zlib.h>
+
 #include "Exception.h"
+#include "OutputContext.h"
 #include "RomDB.h"
 #include "StatusDB.h"
 #include "util.h"
@@ -97,6 +100,10 @@ TomlSchema::TypePtr Configuration::section_schema = TomlSchema::table(
      {"complete-games-only", TomlSchema::boolean()},
      {"complete-list", TomlSchema::string()},
      {"create-fixdat", TomlSchema::boolean()},
+     {"database-cache-size", TomlSchema::integer()},
+     {"database-mmap-size", TomlSchema::integer()},
+     {"database-snapshot", TomlSchema::boolean()},
+     {"database-wal", TomlSchema::boolean()},
      {"dat-directories", dat_directories_schema},
      {"dat-directories-append", dat_directories_schema},
      {"dats", dats_schema},
@@ -104,11 +111,14 @@ TomlSchema::TypePtr Configuration::section_schema = TomlSchema::table(
      {"extra-directories", extra_directories_schema},
      {"extra-directories-append", extra_directories_schema},
      {"fixdat-directory", TomlSchema::string()},
+     {"incremental-check", TomlSchema::boolean()},
+     {"jobs", TomlSchema::integer()},
      {"keep-old-duplicate", TomlSchema::boolean()},
      {"mia-games", TomlSchema::string()},
      {"missing-list", TomlSchema::string()},
      {"move-from-extra", TomlSchema::boolean()},
      {"old-db", TomlSchema::string()},
+     {"prefetch-games", TomlSchema::integer()},
      {"profiles", TomlSchema::array(TomlSchema::string())},
      {"report-changes", TomlSchema::boolean()},
      {"report-correct", TomlSchema::boolean()},
@@ -127,6 +137,7 @@ TomlSchema::TypePtr Configuration::section_schema = TomlSchema::table(
      {"sets", TomlSchema::array(TomlSchema::string())},
      {"sets-file", TomlSchema::string()},
      {"status-db", TomlSchema::string()},
+     {"status-db-delta", TomlSchema::boolean()},
      {"status-db-keep-days",
       TomlSchema::alternatives({TomlSchema::integer(), TomlSchema::constant("all")}, "integer or 'all'")},
      {"status-db-keep-runs",
@@ -161,12 +172,15 @@ std::vector<Commandline::Option> Configuration::commandline_options = {
         "search for missing files in directory dir (multiple directories can be specified by repeating this option)",
         1),
     Commandline::Option("fixdat-directory", "directory", "create fixdats in directory", 1),
+    Commandline::Option("incremental-check", "don't check games whose inputs are unchanged since last run", 1),
+    Commandline::Option("jobs", "n", "use up to n threads (default: 1)", 1),
     Commandline::Option("keep-old-duplicate", "keep files in ROM set that are also in old ROMs", 1),
     Commandline::Option("list-sets", "list all known sets"),
     Commandline::Option("mia-games", "file", "read list of MIA games from file", 1),
     Commandline::Option("missing-list", "file", "write list of missing games to file", 1),
     Commandline::Option("move-from-extra", 'j', "remove used files from extra directories", 1),
     Commandline::Option("no-complete-games-only", "keep partial games in ROM set (default)", 1),
+    Commandline::Option("no-incremental-check", "check all games (default)", 1),
     Commandline::Option("no-create-fixdat", "don't create fixdat (default)", 1),
     Commandline::Option("no-report-changes", "don't report changes to correct and missing lists (default)", 1),
     Commandline::Option("no-report-correct", "don't report status of ROMs that are correct (default)", 1),
@@ -183,6 +197,7 @@ std::vector<Commandline::Option> Configuration::commandline_options = {
     Commandline::Option("no-report-summary", "don't print summary of ROM set status (default)", 1),
     Commandline::Option("no-update-database", "don't update ROM database (default)", 1),
     Commandline::Option("old-db", 'O', "dbfile", "use database dbfile for old ROMs", 1),
+    Commandline::Option("prefetch-games", "n", "read archives of up to n games ahead in background (default: 0)", 1),
     Commandline::Option("report-changes", "report changes to correct and missing lists", 1),
     Commandline::Option("report-correct", 'c',
                         "report status of ROMs that are correct but marked as mia in ROM database", 1),
@@ -202,7 +217,10 @@ std::vector<Commandline::Option> Configuration::commandline_options = {
     Commandline::Option("saved-directory", "directory", "save needed ROMs in directory (default: 'saved')", 1),
     Commandline::Option("set", "pattern", "check ROM sets matching pattern"),
     Commandline::Option("no-status-db", "don't save status in dbfile", 1),
+    Commandline::Option("no-status-db-delta", "store status of all games for each run in status db (default)", 1),
     Commandline::Option("status-db", "dbfile", "use status in dbfile (default: '.ckmame-status.db')", 1),
+    Commandline::Option("status-db-delta", "only store games whose status changed since previous run in status db",
+                        1),
     Commandline::Option("status-db-keep-days", "n",
                         "remove runs older than n days from status db, 'all' for no time limit (default: 'all')", 1),
     Commandline::Option("status-db-keep-runs", "n",
@@ -223,6 +241,7 @@ std::unordered_map<std::string, std::string> Configuration::option_to_variable =
     {"extra-directory", "extra_directories"},
     {"no-complete-games-only", "complete_games_only"},
     {"no-create-fixdat", "create_fixdat"},
+    {"no-incremental-check", "incremental_check"},
     {"no-report-changes", "report_changes"},
     {"no-report-correct", "report_correct"},
     {"no-report-correct-mia", "report_correct_mia"},
@@ -232,6 +251,7 @@ std::unordered_map<std::string, std::string> Configuration::option_to_variable =
     {"no-report-missing-mia", "report_missing_mia"},
     {"no-report-status", "report_status"},
     {"no-report-summary", "report_summary"},
+    {"no-status-db-delta", "status_db_delta"},
     {"no-report-no-good-dump", "report_no_good_dump"},
     {"no-update-database", "update_database"},
     {"no-warn-file-known", "warn-file-known"},
@@ -277,16 +297,25 @@ bool Configuration::option_used(const std::string& option_name, const std::unord
 Configuration::Configuration() : fix_romset(false) { reset(); }
 
 void Configuration::reset() {
+    clear_caches();
+
     allow_empty_dat = false;
     complete_games_only = false;
     complete_list = "";
     create_fixdat = false;
+    database_cache_size = {};
+    database_mmap_size = {};
+    database_snapshot = false;
+    database_wal = true;
     delete_unknown_pattern = "";
+    incremental_check = false;
+    jobs = 1;
     keep_old_duplicate = false;
     mia_games = "";
     missing_list = "";
     move_from_extra = false;
     old_db = RomDB::default_old_name();
+    prefetch_games = 0;
     report_correct = false;
     report_correct_mia = false;
     report_changes = false;
@@ -305,6 +334,7 @@ void Configuration::reset() {
         saved_directory += "/" + set;
     }
     status_db = StatusDB::default_name();
+    status_db_delta = false;
     status_db_keep_runs = 2;
     suffix_only_duplicates = false;
     unknown_directory = "unknown";
@@ -448,6 +478,12 @@ void Configuration::prepare(const std::string& current_set, const ParsedCommandl
         else if (option.name == "fixdat-directory") {
             fixdat_directory = option.argument;
         }
+        else if (option.name == "incremental-check") {
+            incremental_check = true;
+        }
+        else if (option.name == "jobs") {
+            jobs = atoi(option.argument.c_str()); // TODO: better conversion with error checking.
+        }
         else if (option.name == "keep-old-duplicate") {
             keep_old_duplicate = true;
         }
@@ -466,6 +502,9 @@ void Configuration::prepare(const std::string& current_set, const ParsedCommandl
         else if (option.name == "no-create-fixdat") {
             create_fixdat = false;
         }
+        else if (option.name == "no-incremental-check") {
+            incremental_check = false;
+        }
         else if (option.name == "no-report-changes") {
             report_changes = false;
         }
@@ -496,6 +535,9 @@ void Configuration::prepare(const std::string& current_set, const ParsedCommandl
         else if (option.name == "no-status-db") {
             status_db = "none";
         }
+        else if (option.name == "no-status-db-delta") {
+            status_db_delta = false;
+        }
         else if (option.name == "no-update-database") {
             update_database = false;
         }
@@ -508,6 +550,9 @@ void Configuration::prepare(const std::string& current_set, const ParsedCommandl
         else if (option.name == "old-db") {
             old_db = option.argument;
         }
+        else if (option.name == "prefetch-games") {
+            prefetch_games = atoi(option.argument.c_str()); // TODO: better conversion with error checking.
+        }
         else if (option.name == "report-changes") {
             report_changes = true;
         }
@@ -553,6 +598,9 @@ void Configuration::prepare(const std::string& current_set, const ParsedCommandl
         else if (option.name == "status-db") {
             status_db = option.argument;
         }
+        else if (option.name == "status-db-delta") {
+            status_db_delta = true;
+        }
         else if (option.name == "status-db-keep-days") {
             if (option.argument == "all") {
                 status_db_keep_days = {};
@@ -594,6 +642,8 @@ void Configuration::prepare(const std::string& current_set, const ParsedCommandl
             warn_file_unknown = true;
         }
     }
+
+    clear_caches();
 }
 
 
@@ -630,6 +680,10 @@ void Configuration::merge_config_table(const toml::table* table_pointer) {
     set_bool(table, "complete-games-only", complete_games_only);
     set_string(table, "complete-list", complete_list);
     set_bool(table, "create-fixdat", create_fixdat);
+    set_integer_optional(table, "database-cache-size", database_cache_size);
+    set_integer_optional(table, "database-mmap-size", database_mmap_size);
+    set_bool(table, "database-snapshot", database_snapshot);
+    set_bool(table, "database-wal", database_wal);
     merge_dat_directories(table, "dat-directories", false);
     merge_dat_directories(table, "dat-directories-append", true);
     merge_dats(table);
@@ -638,11 +692,14 @@ void Configuration::merge_config_table(const toml::table* table_pointer) {
     merge_extra_directories(table, "extra-directories", false);
     merge_extra_directories(table, "extra-directories-append", true);
     set_string(table, "fixdat-directory", fixdat_directory);
+    set_bool(table, "incremental-check", incremental_check);
+    set_integer(table, "jobs", jobs);
     set_bool(table, "keep-old-duplicate", keep_old_duplicate);
     set_string(table, "mia-games", mia_games);
     set_string(table, "missing-list", missing_list);
     set_bool(table, "move-from-extra", move_from_extra);
     set_string(table, "old-db", old_db);
+    set_integer(table, "prefetch-games", prefetch_games);
     set_bool(table, "report-changes", report_changes);
     set_bool(table, "report-correct", report_correct);
     set_bool(table, "report-correct-mia", report_correct_mia);
@@ -657,6 +714,7 @@ void Configuration::merge_config_table(const toml::table* table_pointer) {
     set_bool(table, "roms-zipped", roms_zipped);
     set_string(table, "saved-directory", saved_directory);
     set_string(table, "status-db", status_db);
+    set_bool(table, "status-db-delta", status_db_delta);
     set_bool(table, "suffix-only-duplicates", suffix_only_duplicates);
     set_integer_or_all(table, "status-db-keep-days", status_db_keep_days);
     set_integer_or_all(table, "status-db-keep-runs", status_db_keep_runs);
@@ -850,6 +908,60 @@ bool Configuration::dat_use_description_as_name(const std::string& dat) {
 }
 
 
+std::shared_ptr<const DatOptions> Configuration::dat_parser_options(const std::optional<std::string>& dat) {
+    auto lock = std::lock_guard(cache_mutex);
+
+    auto it = dat_parser_options_cache.find(dat);
+    if (it != dat_parser_options_cache.end()) {
+        return it->second;
+    }
+
+    auto options = std::make_shared<::DatOptions>();
+    if (dat) {
+        options->game_name_suffix = dat_game_name_suffix(*dat);
+        options->suffix_only_duplicates = dat_suffix_only_duplicates(*dat);
+        options->use_description_as_name = dat_use_description_as_name(*dat);
+    }
+    else {
+        options->use_description_as_name = use_description_as_name;
+    }
+    options->mia_games = mia_game_list();
+    options->mia_games_checksum = mia_game_list_checksum;
+
+    dat_parser_options_cache[dat] = options;
+    return options;
+}
+
+
+std::shared_ptr<const std::unordered_set<std::string>> Configuration::mia_game_list() {
+    if (mia_games.empty()) {
+        return nullptr;
+    }
+    if (!mia_game_list_cache || mia_game_list_file != mia_games) {
+        auto lines = slurp_lines(mia_games);
+        mia_game_list_cache = std::make_shared<const std::unordered_set<std::string>>(lines.begin(), lines.end());
+        mia_game_list_file = mia_games;
+        mia_game_list_checksum = static_cast<uint32_t>(crc32(0, nullptr, 0));
+        for (const auto& line : lines) {
+            mia_game_list_checksum = static_cast<uint32_t>(crc32(mia_game_list_checksum,
+                                                                 reinterpret_cast<const Bytef*>(line.c_str()),
+                                                                 static_cast<uInt>(line.size() + 1)));
+        }
+    }
+    return mia_game_list_cache;
+}
+
+
+void Configuration::clear_caches() {
+    auto lock = std::lock_guard(cache_mutex);
+
+    dat_parser_options_cache.clear();
+    mia_game_list_cache = nullptr;
+    mia_game_list_file = "";
+    mia_game_list_checksum = 0;
+}
+
+
 bool Configuration::extra_directory_move_from_extra(const std::string& directory) {
     auto it = extra_directory_options.find(directory);
     if (it == extra_directory_options.end() || !it->second.move_from_extra.has_value()) {
@@ -34,6 +34,9 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -49,6 +52,8 @@
 #include "Commandline.h"
 #include "TomlSchema.h"
 
+class DatOptions;
+
 /**
  * Configuration settings from file and command line.
  * 
@@ -150,6 +155,17 @@ class Configuration {
      */
     bool dat_use_description_as_name(const std::string& dat);
 
+    /**
+     * Get the options for parsing the given dat, combining the global and per-dat settings.
+     * 
+     * The options are computed once per dat and shared until the configuration is prepared again, so setting up a dat
+     * doesn't depend on the number of configured dats or the size of the MIA list. This function is thread safe.
+     * 
+     * @param dat the name of the dat to get the options for, or no value to use only global settings
+     * @return the options for parsing the dat
+     */
+    std::shared_ptr<const ::DatOptions> dat_parser_options(const std::optional<std::string>& dat);
+
     /**
      * Get `move-from-extra` setting for the given extra directory. This controls whether files taken from the extra directory will be moved instead of copied.
      * 
@@ -193,6 +209,18 @@ class Configuration {
     /// Command line override for `create_fixdat`. This will take precedence over the `create-fixdat` setting in the dat section and the global `create_fixdat` setting.
     std::optional<bool> create_fixdat_override;
 
+    /// Size of the page cache for databases in MiB, overriding the default for each database format.
+    std::optional<int> database_cache_size;
+
+    /// Maximum size of databases to access via memory mapped I/O in MiB, overriding the default for each database format.
+    std::optional<int> database_mmap_size;
+
+    /// Whether to write a compiled snapshot next to ROM databases for faster lookups.
+    bool database_snapshot;
+
+    /// Whether to use write-ahead logging for databases that support it while writing to them.
+    bool database_wal;
+
     /// Directories to search for dat files, in order.
     std::vector<std::string> dat_directories;
 
@@ -208,6 +236,12 @@ class Configuration {
     /// Directory to create fixdats in.
     std::string fixdat_directory;
 
+    /// Whether to skip games whose inputs are unchanged since the last run recorded in the status database.
+    bool incremental_check;
+
+    /// Maximum number of threads to use for work that can be done in parallel.
+    int jobs;
+
     bool keep_old_duplicate;
     std::string mia_games;
     std::string missing_list;
@@ -218,6 +252,9 @@ class Configuration {
 
     std::string old_db;
 
+    /// Number of games ahead of the current one whose archives are read in a background thread, 0 to disable.
+    int prefetch_games;
+
     /// Whether to report changes to the complete or missing lists.
     bool report_changes;     /* report changes to complete or missing lists */
 
@@ -260,6 +297,9 @@ class Configuration {
     /// Name of the status database file to use.
     std::string status_db;
 
+    /// Whether to only store games whose status changed since the previous run in the status database.
+    bool status_db_delta;
+
     /// Keep runs in the status database that are not older than number of days.
     std::optional<int> status_db_keep_days;
 
@@ -508,6 +548,19 @@ class Configuration {
     std::unordered_map<std::string, DatDirectoryOptions> dat_directory_options;
     std::unordered_map<std::string, DatOptions> dat_options;
     std::unordered_map<std::string, ExtraDirectoryOptions> extra_directory_options;
+
+    /// Protects `dat_parser_options_cache` and `mia_game_list_cache`, which are filled from worker threads.
+    std::mutex cache_mutex;
+    std::unordered_map<std::optional<std::string>, std::shared_ptr<const ::DatOptions>> dat_parser_options_cache;
+    /// The `mia_games` file `mia_game_list_cache` was read from.
+    std::string mia_game_list_file;
+    std::shared_ptr<const std::unordered_set<std::string>> mia_game_list_cache;
+    /// Checksum of the lines of `mia_game_list_file`.
+    uint32_t mia_game_list_checksum = 0;
+
+    void clear_caches();
+    /// Get the games listed in the `mia_games` file, read only once. Must be called with `cache_mutex` locked.
+    std::shared_ptr<const std::unordered_set<std::string>> mia_game_list();
 };
 
 #endif // HAD_CONFIGURATION_H
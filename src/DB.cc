@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "Exception.h"
+#include "globals.h"
 #include "util.h"
 
 const int StatementID::have_size = 0x10000;
@@ -144,6 +145,10 @@ void DB::close() {
     statements.clear();
 
     if (db) {
+        if (using_wal) {
+            /* Leave the database in rollback journal mode, so it can be opened read only and copied as a single file. */
+            sqlite3_exec(db, "PRAGMA journal_mode = DELETE", nullptr, nullptr, nullptr);
+        }
         sqlite3_close(db);
     }
 }
@@ -157,6 +162,25 @@ std::string DB::error() const {
 }
 
 
+void DB::begin_transaction() {
+    if (sqlite3_exec(db, "begin transaction", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        throw Exception("can't begin transaction: {}", error());
+    }
+}
+
+
+void DB::commit_transaction() {
+    if (sqlite3_exec(db, "commit transaction", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        auto message = error();
+        rollback_transaction();
+        throw Exception("can't commit transaction: {}", message);
+    }
+}
+
+
+void DB::rollback_transaction() { sqlite3_exec(db, "rollback transaction", nullptr, nullptr, nullptr); }
+
+
 DB::DB(const DB::DBFormat& format, std::string filename_, int mode) : db(nullptr), filename(std::move(filename_)) {
     auto needs_init = false;
 
@@ -226,6 +250,52 @@ void DB::open(const DBFormat& format, int sql3_flags, bool needs_init) {
     else {
         check_version(format);
     }
+
+    tune(format.tuning);
+}
+
+
+void DB::tune(const Tuning& tuning) {
+    // check_version() may have reopened the database read-write for migration.
+    auto read_only = sqlite3_db_readonly(db, "main") == 1;
+
+    auto cache_size = tuning.cache_size;
+    if (configuration.database_cache_size.has_value()) {
+        cache_size = static_cast<int64_t>(configuration.database_cache_size.value()) * 1024;
+    }
+    auto mmap_size = tuning.mmap_size;
+    if (configuration.database_mmap_size.has_value()) {
+        mmap_size = static_cast<int64_t>(configuration.database_mmap_size.value()) * 1024 * 1024;
+    }
+    auto use_wal = !read_only && tuning.use_wal && configuration.database_wal && filename[0] != ':';
+
+    std::string pragmas = "PRAGMA temp_store = MEMORY; ";
+    if (cache_size > 0) {
+        // negative values are in KiB instead of pages
+        pragmas += std::format("PRAGMA cache_size = {}; ", -cache_size);
+    }
+    if (mmap_size > 0) {
+        pragmas += std::format("PRAGMA mmap_size = {}; ", mmap_size);
+    }
+    if (read_only) {
+        pragmas += "PRAGMA query_only = ON; ";
+    }
+
+    if (sqlite3_exec(db, pragmas.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+        throw Exception("can't set options: {}", sqlite3_errmsg(db));
+    }
+
+    if (use_wal) {
+        // The pragma returns the journal mode in effect, which stays unchanged if the file system doesn't support WAL.
+        // If another connection has the database open, it fails and the database stays in its current mode.
+        try {
+            auto stmt = DBStatement(db, "PRAGMA journal_mode = WAL");
+            using_wal = stmt.step() && stmt.get_string("journal_mode") == "wal";
+        }
+        catch (const Exception&) {
+            using_wal = false;
+        }
+    }
 }
 
 
@@ -284,6 +354,14 @@ DBStatement* DB::get_statement_internal(StatementID statement_id) {
         return it->second.get();
     }
 
+    auto stmt = std::make_shared<DBStatement>(db, expand_query(statement_id));
+    statements[statement_id] = stmt;
+
+    return stmt.get();
+}
+
+
+std::string DB::expand_query(StatementID statement_id) const {
     auto sql_query = get_query(statement_id.name, statement_id.is_parameterized());
 
     if (sql_query.empty()) {
@@ -309,8 +387,17 @@ DBStatement* DB::get_statement_internal(StatementID statement_id) {
         }
     }
 
-    auto stmt = std::make_shared<DBStatement>(db, sql_query);
-    statements[statement_id] = stmt;
+    return sql_query;
+}
 
-    return stmt.get();
+
+std::vector<std::string> DB::explain_query_plan(int name, const Hashes& hashes, bool have_size) {
+    auto stmt = DBStatement(db, "explain query plan " + expand_query(StatementID(name, hashes, have_size)));
+    std::vector<std::string> plan;
+
+    while (stmt.step()) {
+        plan.push_back(stmt.get_string("detail"));
+    }
+
+    return plan;
 }
@@ -37,6 +37,7 @@
 #include <filesystem>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <sqlite3.h>
 
@@ -110,12 +111,28 @@ template <> struct hash<StatementID> {
 
 class DB {
   public:
+    /**
+     * SQLite settings tuned to how a database format is used.
+     *
+     * The cache and mmap sizes can be overridden in the configuration file.
+     */
+    class Tuning {
+      public:
+        /// Whether to use write-ahead logging while the database is open for writing.
+        bool use_wal{false};
+        /// Size of the page cache in KiB, 0 for SQLite's default.
+        int64_t cache_size{0};
+        /// Maximum number of bytes of the database to access via memory mapped I/O, 0 to disable.
+        int64_t mmap_size{0};
+    };
+
     class DBFormat {
       public:
         int id;
         int version;
         std::string init_sql;
         std::unordered_map<MigrationVersions, std::string> migrations;
+        Tuning tuning;
     };
 
     DB(const DBFormat& format, std::string filename, int mode);
@@ -125,9 +142,40 @@ class DB {
 
     [[nodiscard]] std::string error() const;
 
+    /**
+     * Start a transaction, to make a batch of changes atomic and avoid syncing after each statement.
+     *
+     * @throw Exception if the transaction can't be started.
+     */
+    void begin_transaction();
+
+    /**
+     * Commit the transaction started by `begin_transaction()`.
+     *
+     * @throw Exception if the transaction can't be committed; it is rolled back in that case.
+     */
+    void commit_transaction();
+
+    /**
+     * Roll back the transaction started by `begin_transaction()`.
+     */
+    void rollback_transaction();
+
     // This is used by dbrestore to create databases with arbitrary schema and version.
     static void upgrade(sqlite3* db, int format, int version, const std::string& statement);
 
+    /**
+     * Get the query plan SQLite chooses for a variant of a parameterized statement.
+     *
+     * This is used by the regression tests to check that lookups don't scan whole tables.
+     *
+     * @param name The parameterized statement.
+     * @param hashes The hash types to look up.
+     * @param have_size Whether the size is looked up.
+     * @return The steps of the query plan, as reported by `explain query plan`.
+     */
+    std::vector<std::string> explain_query_plan(int name, const Hashes& hashes, bool have_size);
+
     // This needs to be public to make it hashable.
 
   protected:
@@ -152,15 +200,18 @@ class DB {
     static const std::unordered_map<MigrationVersions, std::string> no_migrations;
 
     DBStatement* get_statement_internal(StatementID statement_id);
+    [[nodiscard]] std::string expand_query(StatementID statement_id) const;
 
     [[nodiscard]] int get_version(const DBFormat& format) const;
     void check_version(const DBFormat& format);
     void open(const DBFormat& format, int sql3_flags, bool needs_init);
+    void tune(const Tuning& tuning);
     void close();
     void migrate(const DBFormat& format, int from_version, int to_version);
     void upgrade(int format, int version, const std::string& statement) const;
 
     std::string filename;
+    bool using_wal{false};
     std::unordered_map<StatementID, std::shared_ptr<DBStatement>> statements;
 };
 
@@ -55,7 +55,9 @@ empty int\n\
 );\n\
 create index dat_name on dat (name);\n\
 ",
-                                    {}};
+                                    {},
+                                    // No write-ahead log: its files would show up in the dat directory.
+                                    {false, 0, 0}};
 
 std::unordered_map<DatDB::Statement, std::string> DatDB::queries = {
     {DELETE_DATS, "delete from dat where file_id = :file_id"},
@@ -43,6 +43,8 @@ class DatEntry {
     std::string description;
     std::string version;
     uint32_t crc{};
+    /// Checksum of the options the dat was parsed with, see `DatOptions::checksum()`.
+    uint32_t options{};
 
     void merge(const DatEntry* high, const DatEntry* low);
 };
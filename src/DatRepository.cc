@@ -35,6 +35,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <set>
 #include <unordered_set>
 
@@ -45,8 +46,12 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ParserSourceZip.h"
 #include "format.h"
 #include "globals.h"
+#include "parallel.h"
 #include "util.h"
 
+// Number of zip entries to parse in one task; each task has to open the archive.
+static const size_t zip_entries_per_task = 64;
+
 DatRepository::DatRepository(const std::vector<std::string>& directories) {
     for (auto const& directory : directories) {
         if (!std::filesystem::is_directory(directory)) {
@@ -152,6 +157,7 @@ std::vector<std::string> DatRepository::list_dats() {
 void DatRepository::update_directory(const std::string& directory, const DatDBPtr& db) {
     auto dir = Dir(directory, true);
     std::unordered_set<std::string> files;
+    std::vector<ChangedFile> changed_files;
 
     for (const auto& entry : dir) {
         try {
@@ -171,56 +177,112 @@ void DatRepository::update_directory(const std::string& directory, const DatDBPt
 
             time_t db_mtime;
             size_t db_size;
+            auto known = db->get_last_change(file, &db_mtime, &db_size);
 
-            if (db->get_last_change(file, &db_mtime, &db_size)) {
-                if (db_mtime == st.st_mtime && db_size == static_cast<size_t>(st.st_size)) {
-                    continue;
-                }
-                db->delete_file(file);
+            if (known && db_mtime == st.st_mtime && db_size == static_cast<size_t>(st.st_size)) {
+                continue;
             }
 
-            std::vector<DatDB::DatEntry> entries;
+            changed_files.emplace_back(file, entry.path(), st.st_mtime, st.st_size, known);
+        }
+        catch (Exception& ex) {
+            output.error("can't process '{}': {}", entry.path(), ex.what());
+        }
+    }
 
-            try {
-                auto zip_archive = zip_open(entry.path().c_str(), 0, nullptr);
-                if (zip_archive != nullptr) {
-                    for (size_t index = 0; static_cast<int64_t>(index) < zip_get_num_entries(zip_archive, 0); index++) {
-                        try {
-                            auto entry_name = zip_get_name(zip_archive, index, 0);
-                            auto source = std::make_shared<ParserSourceZip>(entry.path(), zip_archive, entry_name);
-                            if (auto header = get_dat_info(source)) {
-                                entries.emplace_back(entry_name, header->name, header->version, header->crc,
-                                                     header->empty);
-                            }
-                        }
-                        catch (Exception& ex) {
-                        }
-                    }
+    // Parsing the headers is independent for each file and zip entry, so it is done in parallel. The database is
+    // updated afterwards, in directory order.
+    parallel_for(changed_files.size(), [&changed_files](size_t index) { scan_file(&changed_files[index]); });
+
+    std::vector<ZipEntries> zip_entries;
+    for (auto& file : changed_files) {
+        for (size_t begin = 0; begin < file.zip_entries; begin += zip_entries_per_task) {
+            zip_entries.emplace_back(&file, begin, std::min(begin + zip_entries_per_task, file.zip_entries));
+        }
+    }
+    parallel_for(zip_entries.size(), [&zip_entries](size_t index) { scan_zip_entries(&zip_entries[index]); });
+
+    auto zip_entries_it = zip_entries.begin();
+    db->begin_transaction();
+    try {
+        for (auto& file : changed_files) {
+            output.print_captured(file.messages);
+            for (; zip_entries_it != zip_entries.end() && zip_entries_it->file == &file; ++zip_entries_it) {
+                output.print_captured(zip_entries_it->messages);
+                for (const auto& dat : zip_entries_it->dats) {
+                    file.dats.push_back(dat);
                 }
-                else {
-                    auto source = std::make_shared<ParserSourceFile>(entry.path());
-                    if (auto header = get_dat_info(source)) {
-                        entries.emplace_back("", header->name, header->version, header->crc, header->empty);
-                    }
+            }
+
+            try {
+                if (file.known) {
+                    db->delete_file(file.file_name);
                 }
+                db->insert_file(file.file_name, file.mtime, file.size, file.dats);
             }
             catch (Exception& ex) {
-                // TODO: warn or ignore?
+                output.error("can't process '{}': {}", file.path, ex.what());
             }
-            db->insert_file(file, st.st_mtime, st.st_size, entries);
         }
-        catch (Exception& ex) {
-            output.error("can't process '{}': {}", entry.path(), ex.what());
+
+        auto db_files = db->list_files();
+
+        for (const auto& file : db_files) {
+            if (files.find(file) == files.end()) {
+                db->delete_file(file);
+            }
         }
     }
+    catch (...) {
+        db->rollback_transaction();
+        throw;
+    }
+    db->commit_transaction();
+}
 
-    auto db_files = db->list_files();
 
-    for (const auto& file : db_files) {
-        if (files.find(file) == files.end()) {
-            db->delete_file(file);
+void DatRepository::scan_file(ChangedFile* file) {
+    output.start_capture();
+    try {
+        auto zip_archive = zip_open(file->path.c_str(), 0, nullptr);
+        if (zip_archive != nullptr) {
+            auto num_entries = zip_get_num_entries(zip_archive, 0);
+            file->zip_entries = num_entries > 0 ? static_cast<size_t>(num_entries) : 0;
+            zip_close(zip_archive);
+        }
+        else {
+            auto source = std::make_shared<ParserSourceFile>(file->path);
+            if (auto header = get_dat_info(source)) {
+                file->dats.emplace_back("", header->name, header->version, header->crc, header->empty);
+            }
+        }
+    }
+    catch (Exception& ex) {
+        // TODO: warn or ignore?
+    }
+    file->messages = output.end_capture();
+}
+
+
+void DatRepository::scan_zip_entries(ZipEntries* entries) {
+    output.start_capture();
+    // Each task opens the archive itself, so entries can be parsed on different threads.
+    auto zip_archive = zip_open(entries->file->path.c_str(), 0, nullptr);
+    if (zip_archive != nullptr) {
+        for (auto index = entries->begin; index < entries->end; index++) {
+            try {
+                auto entry_name = zip_get_name(zip_archive, index, 0);
+                auto source = std::make_shared<ParserSourceZip>(entries->file->path, zip_archive, entry_name);
+                if (auto header = get_dat_info(source)) {
+                    entries->dats.emplace_back(entry_name, header->name, header->version, header->crc, header->empty);
+                }
+            }
+            catch (Exception& ex) {
+            }
         }
+        zip_close(zip_archive);
     }
+    entries->messages = output.end_capture();
 }
 
 
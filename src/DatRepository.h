@@ -34,10 +34,12 @@ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
 IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <filesystem>
 #include <string>
 #include <vector>
 
 #include "DatDb.h"
+#include "Output.h"
 #include "Parser.h"
 class DatRepository {
   public:
@@ -73,10 +75,50 @@ class DatRepository {
         uint32_t crc;
         bool empty;
     };
+    /**
+     * A file in a dat directory that is new or changed since it was last scanned.
+     */
+    class ChangedFile {
+      public:
+        ChangedFile(std::string file_name, std::filesystem::path path, time_t mtime, size_t size, bool known)
+            : file_name(std::move(file_name)), path(std::move(path)), mtime(mtime), size(size), known(known) {}
+
+        std::string file_name;
+        std::filesystem::path path;
+        time_t mtime;
+        size_t size;
+        /// Whether the file is in the database and has to be deleted before it is inserted again.
+        bool known;
+
+        /// Number of entries if the file is a zip archive, 0 otherwise.
+        size_t zip_entries{0};
+        /// Dats found in the file, in entry order.
+        std::vector<DatDB::DatEntry> dats;
+        /// Messages printed while scanning the file.
+        std::vector<Output::CapturedMessage> messages;
+    };
+
+    /**
+     * A range of entries of a zip archive, scanned together.
+     */
+    class ZipEntries {
+      public:
+        ZipEntries(ChangedFile* file, size_t begin, size_t end) : file(file), begin(begin), end(end) {}
+
+        ChangedFile* file;
+        size_t begin;
+        size_t end;
+        std::vector<DatDB::DatEntry> dats;
+        std::vector<Output::CapturedMessage> messages;
+    };
+
     std::unordered_map<std::string, DatDBPtr> dbs;
 
     static std::optional<DatInfo> get_dat_info(ParserSourcePtr source);
 
+    static void scan_file(ChangedFile* file);
+    static void scan_zip_entries(ZipEntries* entries);
+
     static void update_directory(const std::string& directory, const DatDBPtr& db);
 };
 
@@ -34,7 +34,9 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <deque>
 #include <memory>
+#include <optional>
 #include <unordered_set>
 #include <vector>
 
@@ -69,7 +71,23 @@ class Detector {
         std::vector<uint8_t> value;
         bool result;
 
-        [[nodiscard]] bool execute(const std::vector<uint8_t>& data) const;
+        /**
+         * Get offset of data this test compares.
+         *
+         * @param size Size of the file.
+         * @return Offset of the `length` bytes to compare, or no value if this test doesn't compare data or the data
+         * is not within the file.
+         */
+        [[nodiscard]] std::optional<uint64_t> data_offset(uint64_t size) const;
+
+        /**
+         * Run test.
+         *
+         * @param data The `length` bytes at `data_offset(size)`, ignored if that has no value.
+         * @param size Size of the file.
+         * @return Whether the file passes the test.
+         */
+        [[nodiscard]] bool execute(const uint8_t* data, uint64_t size) const;
         void print(std::ostream& out) const;
 
       private:
@@ -85,12 +103,86 @@ class Detector {
         Operation operation;
         std::vector<Test> tests;
 
-        [[nodiscard]] Hashes execute(const std::vector<uint8_t>& data) const;
         void print(std::ostream& out) const;
+    };
+
+    /**
+     * Run detectors on file data passed in blocks, in order. Memory use doesn't depend on file size.
+     *
+     * All detectors added see the same data. Data needed by tests is buffered once for all detectors, and rules of
+     * different detectors covering the same range with the same operation share one hash computation.
+     */
+    class Execution {
+      public:
+        explicit Execution(uint64_t size);
+
+        /// Add detector to run, must be called before first `update()`. Returns index to pass to `end()`.
+        size_t add(const Detector& detector);
+
+        /// Process next `length` bytes of file.
+        void update(const uint8_t* data, size_t length);
+
+        /// Get size and hashes of the first matching rule of detector `index`, empty if no rule matches.
+        [[nodiscard]] Hashes end(size_t index);
 
       private:
-        [[nodiscard]] Hashes compute_values(Operation operation, const std::vector<uint8_t>& data, uint64_t start,
-                                            uint64_t length) const;
+        enum State { UNDECIDED, PASSED, FAILED };
+
+        /// Part of the file needed by tests.
+        class Window {
+          public:
+            uint64_t offset{};
+            uint64_t length{};
+            std::vector<uint8_t> data;
+        };
+
+        /// Range of the file hashed after applying operation.
+        class Range {
+          public:
+            uint64_t start{};
+            uint64_t end{};
+            Operation operation{OP_NONE};
+            /// Number of undecided or passed rules using this range.
+            size_t users{};
+            Hashes hashes;
+            std::unique_ptr<Hashes::Update> hashes_update;
+            uint8_t pending[4]{};
+            size_t pending_length{};
+
+            void hash(const uint8_t* data, size_t length, std::vector<uint8_t>& buffer);
+            void release();
+        };
+
+        class TestData {
+          public:
+            const Test* test{};
+            /// Index into `windows`, or no value if test doesn't compare data or the data is not within the file.
+            std::optional<size_t> window;
+            uint64_t window_offset{};
+        };
+
+        class RuleExecution {
+          public:
+            State state{UNDECIDED};
+            /// Position after which all data needed by the tests has been seen.
+            uint64_t decided_at{};
+            std::vector<TestData> tests;
+            Range* range{};
+        };
+
+        uint64_t size;
+        uint64_t position{0};
+        std::vector<std::vector<RuleExecution>> detectors;
+        std::vector<Window> windows;
+        // Hashes::Update keeps a pointer to the hashes, so ranges must not move.
+        std::deque<Range> ranges;
+        std::vector<uint8_t> buffer;
+
+        size_t add_window(uint64_t offset, uint64_t length);
+        Range* add_range(uint64_t start, uint64_t end, Operation operation);
+        void advance(std::vector<RuleExecution>& rules) const;
+        void decide(RuleExecution& rule) const;
+        static void fail(RuleExecution& rule);
     };
 
 
@@ -101,12 +193,9 @@ class Detector {
 
     std::vector<Rule> rules;
 
-    static const uint64_t MAX_DETECTOR_FILE_SIZE;
-
     static DetectorPtr parse(const std::string& filename);
     static DetectorPtr parse(ParserSource* parser_source);
 
-    [[nodiscard]] Hashes execute(const std::vector<uint8_t>& data) const;
     bool print(std::ostream& out) const;
 
     static std::string file_test_type_name(TestType type);
@@ -116,13 +205,14 @@ class Detector {
     static size_t get_id(const DetectorDescriptor& descriptor) { return detector_ids.get_id(descriptor); }
     static const DetectorDescriptor* get_descriptor(size_t id) { return detector_ids.get_descriptor(id); }
 
-    // Returns true if new hashes were computed.
-    static bool compute_hashes(const std::vector<uint8_t>& data, File* file,
+    // Returns true if new hashes were computed. Throws `Exception` on read error.
+    static bool compute_hashes(const ZipSource* source, File* file,
                                const std::unordered_map<size_t, DetectorPtr>& detectors,
                                std::unordered_set<size_t>* changed = {});
 
   private:
     static uint64_t operation_unit_size(Operation operation);
+    static void apply_operation(Operation operation, const uint8_t* data, uint8_t* result, size_t length);
     static DetectorCollection detector_ids;
 };
 
@@ -35,6 +35,30 @@
 
 #include <algorithm>
 
+namespace {
+// FNV-1a, 64 bit.
+class Fingerprint {
+  public:
+    void add(const std::string& string) {
+        for (auto c : string) {
+            add_byte(static_cast<uint8_t>(c));
+        }
+        // Terminate strings, so "ab" "c" and "a" "bc" differ.
+        add_byte(0);
+    }
+    void add(uint64_t value) {
+        for (size_t i = 0; i < 8; i++) {
+            add_byte(static_cast<uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    uint64_t value{0xcbf29ce484222325};
+
+  private:
+    void add_byte(uint8_t byte) { value = (value ^ byte) * 0x100000001b3; }
+};
+} // namespace
+
 bool Game::is_mia() const {
     for (size_t ft = 0; ft < TYPE_MAX; ft++) {
         if (std::any_of(files[ft].begin(), files[ft].end(), [](const Rom& rom) { return rom.mia; })) {
@@ -57,6 +81,26 @@ bool Game::operator==( const Game& other ) const {
 }
 
 
+uint64_t Game::fingerprint() const {
+    Fingerprint fingerprint;
+
+    fingerprint.add(cloneof[0]);
+    fingerprint.add(cloneof[1]);
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        fingerprint.add(files[ft].size());
+        for (const auto& rom : files[ft]) {
+            fingerprint.add(rom.name);
+            fingerprint.add(rom.merge);
+            fingerprint.add(static_cast<uint64_t>(rom.status));
+            fingerprint.add(static_cast<uint64_t>(rom.where));
+            fingerprint.add(static_cast<uint64_t>(rom.mia));
+        }
+    }
+
+    return fingerprint.value;
+}
+
+
 Rom* Game::find_mergeable_file(filetype_t filetype, const Rom* file) {
     for (auto& f : files[filetype]) {
         if (file->is_mergeable(f)) {
@@ -72,6 +72,16 @@ struct Game {
     * @return true if the games are identical, false otherwise
     */
     bool operator==( const Game& other ) const;
+
+    /**
+     * Compute a fingerprint of the fields `operator==` compares exactly.
+     *
+     * Equal games have equal fingerprints, so it can be used to rule out equality cheaply. Sizes and hashes are not
+     * included, since unknown values compare equal to anything.
+     *
+     * @return the fingerprint
+     */
+    [[nodiscard]] uint64_t fingerprint() const;
 };
 
 typedef std::shared_ptr<Game> GamePtr;
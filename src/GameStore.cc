@@ -0,0 +1,124 @@
+/*
+  GameStore.cc -- in-memory copy of all games in ROM database
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "GameStore.h"
+
+#include "RomDB.h"
+
+GameStore game_store;
+
+static size_t string_memory(const std::string& string) {
+    // Short strings are stored inline.
+    return string.capacity() > std::string().capacity() ? string.capacity() + 1 : 0;
+}
+
+
+void GameStore::load(RomDB* rom_db) {
+    clear();
+
+    rom_db->read_games(games);
+
+    games_by_name.reserve(games.size());
+    for (auto& game : games) {
+        games_by_name[game.name] = &game;
+    }
+
+    for (auto& game : games) {
+        if (game.cloneof[0].empty()) {
+            continue;
+        }
+        auto it = games_by_name.find(game.cloneof[0]);
+        if (it != games_by_name.end()) {
+            game.cloneof[1] = it->second->cloneof[0];
+        }
+    }
+
+    loaded = true;
+}
+
+
+void GameStore::clear() {
+    games_by_name.clear();
+    games.clear();
+    loaded = false;
+}
+
+
+GamePtr GameStore::get(const std::string& name) const {
+    if (!loaded) {
+        return db->read_game(name);
+    }
+
+    auto it = games_by_name.find(name);
+    if (it == games_by_name.end()) {
+        return nullptr;
+    }
+
+    // The store owns the game, so the returned pointer doesn't.
+    return {GamePtr(), it->second};
+}
+
+
+size_t GameStore::file_count() const {
+    size_t count = 0;
+
+    for (const auto& game : games) {
+        for (const auto& files : game.files) {
+            count += files.size();
+        }
+    }
+
+    return count;
+}
+
+
+size_t GameStore::memory_usage() const {
+    size_t usage = games.size() * sizeof(Game);
+
+    for (const auto& game : games) {
+        usage += string_memory(game.name) + string_memory(game.original_name) + string_memory(game.description);
+        usage += string_memory(game.cloneof[0]) + string_memory(game.cloneof[1]);
+        for (const auto& files : game.files) {
+            usage += files.capacity() * sizeof(Rom);
+            for (const auto& rom : files) {
+                usage += string_memory(rom.name) + string_memory(rom.merge);
+                usage += rom.hashes.md5.capacity() + rom.hashes.sha1.capacity() + rom.hashes.sha256.capacity();
+            }
+        }
+    }
+
+    usage += games_by_name.bucket_count() * sizeof(void*);
+    usage += games_by_name.size() * (sizeof(std::pair<std::string_view, Game*>) + sizeof(void*));
+
+    return usage;
+}
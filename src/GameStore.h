@@ -0,0 +1,98 @@
+#ifndef HAD_GAME_STORE_H
+#define HAD_GAME_STORE_H
+
+/*
+  GameStore.h -- in-memory copy of all games in ROM database
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Game.h"
+
+class RomDB;
+
+/**
+ * In-memory copy of all games in a ROM database.
+ *
+ * Checking a complete ROM set needs every game at least twice (to build the tree and to check it). Loading them all
+ * with one pass over the game and file tables avoids several queries per game.
+ */
+class GameStore {
+  public:
+    /**
+     * Load all games from the ROM database, replacing any previously loaded games.
+     *
+     * @param rom_db the ROM database to load from
+     */
+    void load(RomDB* rom_db);
+
+    /// Discard all loaded games.
+    void clear();
+
+    /**
+     * Get a game by name. If no games have been loaded, it is read from the ROM database.
+     *
+     * Games returned from the store are owned by it and stay valid until it is cleared.
+     *
+     * @param name the name of the game
+     * @return the game, or `nullptr` if there is no game with that name
+     */
+    [[nodiscard]] GamePtr get(const std::string& name) const;
+
+    /// Whether games have been loaded.
+    [[nodiscard]] bool is_loaded() const { return loaded; }
+
+    /// Number of loaded games.
+    [[nodiscard]] size_t size() const { return games.size(); }
+
+    /// Number of loaded files of all types.
+    [[nodiscard]] size_t file_count() const;
+
+    /// Approximate number of bytes used by the loaded games.
+    [[nodiscard]] size_t memory_usage() const;
+
+  private:
+    bool loaded{false};
+
+    /// Games in `game_id` order. A deque allocates in large blocks and never moves its elements.
+    std::deque<Game> games;
+
+    /// Index of games by name; the keys refer to the names stored in `games`.
+    std::unordered_map<std::string_view, Game*> games_by_name;
+};
+
+extern GameStore game_store;
+
+#endif // HAD_GAME_STORE_H
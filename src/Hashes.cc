@@ -33,6 +33,7 @@
 
 #include "Hashes.h"
 
+#include <charconv>
 #include <cinttypes>
 #include <utility>
 
@@ -391,26 +392,26 @@ std::string Hashes::to_string(int type) const {
 }
 
 
-int Hashes::set_from_string(const std::string& s) {
+int Hashes::set_from_string(std::string_view s) {
     auto str = s;
 
     /* remove leading & trailing whitespace */
     auto data_start = str.find_first_not_of(" \t\n\r");
-    if (data_start != std::string::npos) {
-        str = str.substr(data_start);
+    if (data_start != std::string_view::npos) {
+        str.remove_prefix(data_start);
     }
     auto data_end = str.find_last_not_of(" \t\n\r");
-    if (data_end != std::string::npos) {
-        str = str.substr(0, data_end + 1);
+    if (data_end != std::string_view::npos) {
+        str.remove_suffix(str.length() - data_end - 1);
     }
 
-    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
-        str = str.substr(2);
+    if (str.length() >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        str.remove_prefix(2);
     }
 
     size_t length = str.length();
 
-    if (length % 2 != 0 || str.find_first_not_of("0123456789ABCDEFabcdef") != std::string::npos) {
+    if (length % 2 != 0 || str.find_first_not_of("0123456789ABCDEFabcdef") != std::string_view::npos) {
         return -1;
     }
 
@@ -419,7 +420,7 @@ int Hashes::set_from_string(const std::string& s) {
     switch (length / 2) {
     case Hashes::SIZE_CRC:
         type = Hashes::TYPE_CRC;
-        crc = static_cast<uint32_t>(std::stoul(str, nullptr, 16));
+        std::from_chars(str.data(), str.data() + str.length(), crc, 16);
         break;
 
     case Hashes::SIZE_MD5:
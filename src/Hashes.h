@@ -37,6 +37,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -97,7 +98,7 @@ class Hashes {
     void set_sha1(const uint8_t* data, bool ignore_zero = false);
     void set_sha256(const std::vector<uint8_t>& data, bool ignore_zero = false);
     void set_sha256(const uint8_t* data, bool ignore_zero = false);
-    int set_from_string(const std::string& s);
+    int set_from_string(std::string_view s);
 
     static int types_from_string(const std::string& s);
     static std::string type_name(int type);
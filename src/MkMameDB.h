@@ -34,6 +34,8 @@
 #ifndef MKMAMEDB_H
 #define MKMAMEDB_H
 
+#include <functional>
+
 #include "Command.h"
 #include "OutputContext.h"
 #include "Parser.h"
@@ -47,8 +49,27 @@ class MkMameDB : public Command {
     bool global_cleanup() override;
 
   private:
-    bool process_file(const std::string& fname, OutputContext* out);
+    /**
+     * A part of the input, processed in the order given on the command line.
+     */
+    class Input {
+      public:
+        Input(std::function<bool(OutputContext*)> process, bool parallel)
+            : process(std::move(process)), parallel(parallel) {}
+
+        /// Add this input to the given output context, returns `false` on error.
+        std::function<bool(OutputContext*)> process;
+
+        /// Whether `process` can be run on a worker thread.
+        bool parallel;
+    };
+
+    void add_inputs(const std::string& fname, std::vector<Input>& inputs);
+    bool process_dat_file(const std::string& fname, OutputContext* out);
+    bool process_directory(const std::string& fname, OutputContext* out);
+    bool process_romdb(const std::string& fname, OutputContext* out);
     bool process_stdin(OutputContext* out);
+    bool process_zip_member(const std::string& archive_name, const std::string& name, OutputContext* out);
 
     DatOptions parser_options{};
     std::string dbname, dbname_real;
@@ -61,6 +82,7 @@ class MkMameDB : public Command {
     std::string detector_name;
     bool force{false};
     bool runtest{false};
+    bool low_memory{false};
 
     bool list_available_dats{false};
     bool list_dats{false};
@@ -43,7 +43,32 @@
 std::string Output::empty_string;
 
 Output::Output()
-    : first_header(true), header_done(false), subheader_done(false), file_infos({FileInfo("", "")}), db(nullptr) {}
+    : first_header(true), header_done(false), subheader_done(false), file_infos({FileInfo("", "")}), db(nullptr),
+      capturing(false) {}
+
+
+void Output::start_capture() {
+    capturing = true;
+    captured.clear();
+}
+
+
+std::vector<Output::CapturedMessage> Output::end_capture() {
+    capturing = false;
+    return std::move(captured);
+}
+
+
+void Output::print_captured(const std::vector<CapturedMessage>& messages) {
+    for (const auto& message : messages) {
+        if (message.is_error) {
+            std::cerr << message.text << std::endl;
+        }
+        else {
+            print_message(message.text);
+        }
+    }
+}
 
 void Output::set_header(std::string new_header) {
     header = std::move(new_header);
@@ -104,6 +129,10 @@ void Output::print_message_verbose(std::string_view string) {
 }
 
 void Output::print_message(std::string_view string) {
+    if (capturing) {
+        captured.emplace_back(false, std::string(string));
+        return;
+    }
     print_header();
     std::cout << string << std::endl;
 }
@@ -112,15 +141,20 @@ void Output::print_message(std::string_view string) {
 void Output::print_error(std::string_view string, std::string_view prefix, std::string_view postfix) {
     // Don't print header to stdout for error messages printed to stderr.
 
-    std::cerr << ProgramName::get() << ": ";
+    auto text = ProgramName::get() + ": ";
     if (!prefix.empty()) {
-        std::cerr << prefix << ": ";
+        text += std::string(prefix) + ": ";
     }
-    std::cerr << string;
+    text += string;
     if (!postfix.empty()) {
-        std::cerr << ": " << postfix;
+        text += ": " + std::string(postfix);
+    }
+
+    if (capturing) {
+        captured.emplace_back(true, std::move(text));
+        return;
     }
-    std::cerr << std::endl;
+    std::cerr << text << std::endl;
 }
 
 
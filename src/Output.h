@@ -37,6 +37,7 @@
 #include <format>
 #include <string>
 #include <system_error>
+#include <vector>
 
 #include "DB.h"
 
@@ -62,8 +63,43 @@ class Output {
         }
     };
 
+    /**
+     * A message or error collected while capturing output.
+     */
+    class CapturedMessage {
+      public:
+        CapturedMessage(bool is_error, std::string text) : is_error(is_error), text(std::move(text)) {}
+
+        /// Whether this is an error message, printed to stderr.
+        bool is_error;
+        /// The complete text of the message, without trailing newline.
+        std::string text;
+    };
+
     Output();
 
+    /**
+     * Start collecting messages and errors instead of printing them.
+     *
+     * This is used by worker threads, whose output is printed later by the main thread, in the order the work would
+     * have been done serially.
+     */
+    void start_capture();
+
+    /**
+     * Stop collecting messages and errors.
+     *
+     * @return The messages and errors collected since `start_capture()` was called.
+     */
+    std::vector<CapturedMessage> end_capture();
+
+    /**
+     * Print messages and errors collected by another `Output`.
+     *
+     * @param messages The messages to print.
+     */
+    void print_captured(const std::vector<CapturedMessage>& messages);
+
     /**
      * Set the current header.
      *
@@ -513,6 +549,12 @@ class Output {
     /// @brief The database to use for error messages.
     DB* db;
 
+    /// @brief Whether messages are collected in `captured` instead of printed.
+    bool capturing;
+
+    /// @brief The messages collected while capturing.
+    std::vector<CapturedMessage> captured;
+
     /// @brief Print the current header and subheader if they have not been printed yet.
     void print_header();
 
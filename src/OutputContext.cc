@@ -36,12 +36,18 @@
 #include "OutputContext.h"
 
 #include <algorithm>
+#include <array>
 #include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <zlib.h>
 
 #include "OutputContextCm.h"
 #include "OutputContextDb.h"
 #include "OutputContextMtree.h"
 #include "OutputContextXml.h"
+#include "file_util.h"
 #include "globals.h"
 #include "util.h"
 
@@ -73,6 +79,24 @@ OutputContextPtr OutputContext::create(OutputContext::Format format, const std::
 }
 
 
+OutputContext::~OutputContext() { close_staging_database(); }
+
+
+void OutputContext::use_staging_database() {
+    staging_file_name = make_unique_path(std::filesystem::temp_directory_path() / "mkmamedb-games.db");
+    staging = std::make_unique<StagingDB>(staging_file_name);
+}
+
+
+void OutputContext::close_staging_database() {
+    if (staging) {
+        staging = nullptr;
+        std::error_code ec;
+        std::filesystem::remove(staging_file_name, ec);
+    }
+}
+
+
 bool OutputContext::start_dat(DatOptions options, Output::FileInfo file_info) {
     dats.emplace_back(options, file_info);
     return true;
@@ -84,6 +108,7 @@ bool OutputContext::add_header(const DatEntry& dat) {
         return false;
     }
     dats[current_dat_no()].dat = dat;
+    dats[current_dat_no()].dat->options = current_dat().options.checksum();
     return true;
 }
 
@@ -103,18 +128,37 @@ bool OutputContext::add_game(GamePtr game) {
         output.error("start_dat must be called before add_game");
         return false;
     }
+    auto fingerprint = game->fingerprint();
+    if (staging) {
+        if (current_dat().options.only_last_duplicate) {
+            staging->delete_games(game->name);
+        }
+        else {
+            for (const auto& g : staging->read_games(game->name, fingerprint)) {
+                if (*g == *game) {
+                    return true;
+                }
+            }
+        }
+        game->dat_no = current_dat_no();
+        staging->insert_game(game.get(), fingerprint);
+        return true;
+    }
+    auto& named_games = games_by_name[game->name];
     if (current_dat().options.only_last_duplicate) {
-        games_by_name[game->name].clear();
+        named_games.games.clear();
+        named_games.fingerprints.clear();
     }
     else {
-        for (const auto& g : games_by_name[game->name]) {
-            if (*g == *game) {
+        for (size_t i = 0; i < named_games.games.size(); i++) {
+            if (named_games.fingerprints[i] == fingerprint && *named_games.games[i] == *game) {
                 return true;
             }
         }
     }
     game->dat_no = current_dat_no();
-    games_by_name[game->name].push_back(game);
+    named_games.games.push_back(game);
+    named_games.fingerprints.push_back(fingerprint);
     return true;
 }
 
@@ -139,43 +183,45 @@ bool OutputContext::finish() {
         return true;
     }
 
-    // Fix duplicate names.
-    for (const auto& [name, named_games] : games_by_name) {
-        if (named_games.size() > 1) {
-            std::unordered_map<std::string, int> counts;
-
+    if (staging) {
+        // Fix duplicate names.
+        for (const auto& name : staging->duplicate_names()) {
+            auto named_games = staging->read_games(name);
+            rename_duplicates(named_games);
             for (const auto& game : named_games) {
-                auto suffix = dats[game->dat_no].options.duplicate_name_suffix();
-                auto original_name = game->name;
-                auto new_name = game->name;
-                if (!suffix.empty()) {
-                    new_name += suffix;
-                }
-                if (counts[new_name] > 0) {
-                    new_name += " (" + std::to_string(counts[new_name]) + ")";
-                    output.error("warning: duplicate game '{}', renamed to '{}'", original_name, new_name);
-                }
-                counts[new_name] += 1;
-                game->name = new_name;
+                staging->set_name(*game);
+            }
+        }
+
+        // Fix other game fields, each game is read once more for every clone.
+        uint64_t last_id = 0;
+        GamePtr game;
+        while ((game = staging->read_next_unfixed_game(last_id))) {
+            last_id = game->id;
+            if (!fix_game(game.get())) {
+                ok = false;
+            }
+        }
+    }
+    else {
+        // Fix duplicate names.
+        for (const auto& [name, named_games] : games_by_name) {
+            if (named_games.games.size() > 1) {
+                rename_duplicates(named_games.games);
+            }
+            for (const auto& game : named_games.games) {
                 games[game->name] = game;
                 if (game->name != game->original_name) {
                     renamed_games[Name(game->dat_no, game->original_name)] = game->name;
                 }
             }
         }
-        else {
-            auto game = named_games[0];
-            games[game->name] = game;
-            if (game->name != game->original_name) {
-                renamed_games[Name(game->dat_no, game->original_name)] = game->name;
-            }
-        }
-    }
 
-    // Fix other game fields.
-    for (const auto& [name, game] : games) {
-        if (!fix_game(game.get())) {
-            ok = false;
+        // Fix other game fields.
+        for (const auto& [name, game] : games) {
+            if (!fix_game(game.get())) {
+                ok = false;
+            }
         }
     }
 
@@ -201,20 +247,59 @@ bool OutputContext::finish() {
     }
 
     // Write games.
-    std::vector<GamePtr> sorted_games;
-    for (const auto& [name, game] : games) {
-        sorted_games.push_back(game);
+    if (staging) {
+        staging->for_each_game_sorted([this](GamePtr game) { write_game(game); });
+        close_staging_database();
     }
-    std::sort(sorted_games.begin(), sorted_games.end(),
-              [](const GamePtr& a, const GamePtr& b) { return a->name < b->name; });
-    for (const auto& game : sorted_games) {
-        write_game(game);
+    else {
+        std::vector<GamePtr> sorted_games;
+        for (const auto& [name, game] : games) {
+            sorted_games.push_back(game);
+        }
+        std::sort(sorted_games.begin(), sorted_games.end(),
+                  [](const GamePtr& a, const GamePtr& b) { return a->name < b->name; });
+        for (const auto& game : sorted_games) {
+            write_game(game);
+        }
     }
 
     return close();
 }
 
 
+void OutputContext::rename_duplicates(const std::vector<GamePtr>& named_games) const {
+    std::unordered_map<std::string, int> counts;
+
+    for (const auto& game : named_games) {
+        auto suffix = dats[game->dat_no].options.duplicate_name_suffix();
+        auto original_name = game->name;
+        auto new_name = game->name;
+        if (!suffix.empty()) {
+            new_name += suffix;
+        }
+        if (counts[new_name] > 0) {
+            new_name += " (" + std::to_string(counts[new_name]) + ")";
+            output.error("warning: duplicate game '{}', renamed to '{}'", original_name, new_name);
+        }
+        counts[new_name] += 1;
+        game->name = new_name;
+    }
+}
+
+
+GamePtr OutputContext::find_game(const std::string& name) const {
+    if (staging) {
+        return staging->read_game(name);
+    }
+
+    auto it = games.find(name);
+    if (it == games.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+
 std::strong_ordering OutputContext::Name::operator<=>(const Name& other) const {
     if (dat_no != other.dat_no) {
         return dat_no <=> other.dat_no;
@@ -223,10 +308,13 @@ std::strong_ordering OutputContext::Name::operator<=>(const Name& other) const {
 }
 
 
-const std::string& OutputContext::final_game_name(size_t dat_no, const std::string& name) const {
+std::string OutputContext::final_game_name(size_t dat_no, const std::string& name) const {
     if (name.empty()) {
         return name;
     }
+    if (staging) {
+        return staging->renamed_game(dat_no, name).value_or(name);
+    }
     auto it = renamed_games.find(Name(dat_no, name));
     if (it != renamed_games.end()) {
         return it->second;
@@ -235,87 +323,152 @@ const std::string& OutputContext::final_game_name(size_t dat_no, const std::stri
 }
 
 
-DatOptions::DatOptions(std::optional<std::string> dat_name) {
-    if (dat_name) {
-        game_name_suffix = configuration.dat_game_name_suffix(*dat_name);
-        suffix_only_duplicates = configuration.dat_suffix_only_duplicates(*dat_name);
-        use_description_as_name = configuration.dat_use_description_as_name(*dat_name);
-    }
-    else {
-        use_description_as_name = configuration.use_description_as_name;
+DatOptions::DatOptions(std::optional<std::string> dat_name) : DatOptions(*configuration.dat_parser_options(dat_name)) {}
+
+
+uint32_t DatOptions::checksum() const {
+    if (!full_archive_names && game_name_suffix.empty() && !suffix_only_duplicates && !use_description_as_name &&
+        !mia_games) {
+        return 0;
     }
-    if (!configuration.mia_games.empty()) {
-        auto list = slurp_lines(configuration.mia_games);
-        mia_games.insert(list.begin(), list.end());
+
+    auto data = game_name_suffix;
+    data += '\0';
+    data += full_archive_names ? '1' : '0';
+    data += suffix_only_duplicates ? '1' : '0';
+    data += use_description_as_name ? '1' : '0';
+    if (mia_games) {
+        data += std::to_string(mia_games_checksum);
     }
+
+    return static_cast<uint32_t>(
+        crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())));
 }
 
 
-bool OutputContext::fix_game(Game* game, std::unordered_set<Game*> fixing) {
-    if (fixed_where_games.contains(game)) {
+bool OutputContext::fix_game(Game* game) {
+    if (!mark_fixed(game)) {
         return true;
     }
-    fixed_where_games.insert(game);
 
-    const auto& error_info = dats[game->dat_no].error_info;
+    std::vector<FixingGame> fixing{FixingGame(game)};
+    // Names of the games in fixing, a parent among them closes a cycle.
+    std::unordered_set<std::string> fixing_names{game->name};
 
-    if (fixing.contains(game)) {
-        output.file_info_error(error_info, "circular cloneof detected for game '{}'", game->name);
-        return false;
+    while (!fixing.empty()) {
+        auto& entry = fixing.back();
+        auto current = entry.game;
+
+        if (entry.next_parent == entry.parents.size()) {
+            finish_fixed_game(current, entry.parents);
+            fixing_names.erase(current->name);
+            fixing.pop_back();
+            continue;
+        }
+
+        auto i = entry.next_parent;
+        if (entry.parent_fixed) {
+            entry.parent_fixed = false;
+            entry.next_parent += 1;
+            if (!inherit_ancestors(current, entry.parents[i].get(), i)) {
+                return false;
+            }
+            continue;
+        }
+
+        current->cloneof[i] = final_game_name(current->dat_no, current->cloneof[i]);
+        if (current->cloneof[i].empty()) {
+            entry.next_parent += 1;
+            continue;
+        }
+
+        auto parent = find_game(current->cloneof[i]);
+        if (!parent) {
+            output.file_info_error(dats[current->dat_no].error_info, "inconsistency: {} has non-existent parent {}",
+                                   current->name, current->cloneof[i]);
+            current->cloneof[i] = "";
+            entry.next_parent += 1;
+            continue;
+        }
+
+        // Must come before the fixed check, games in a cycle are already marked as fixed.
+        if (fixing_names.contains(parent->name)) {
+            output.file_info_error(dats[current->dat_no].error_info, "circular cloneof detected for game '{}'",
+                                   parent->name);
+            current->cloneof[i] = "";
+            entry.next_parent += 1;
+            continue;
+        }
+
+        entry.parents[i] = parent;
+        entry.parent_fixed = true;
+        if (mark_fixed(parent.get())) {
+            fixing_names.insert(parent->name);
+            // Invalidates entry.
+            fixing.emplace_back(parent.get());
+        }
+    }
+
+    return true;
+}
+
+
+bool OutputContext::mark_fixed(Game* game) {
+    if (staging) {
+        if (staging->is_fixed(*game)) {
+            return false;
+        }
+        staging->set_fixed(*game);
+    }
+    else {
+        if (fixed_where_games.contains(game)) {
+            return false;
+        }
+        fixed_where_games.insert(game);
     }
-    fixing.insert(game);
 
     if (game->original_name == game->name) {
         game->original_name = "";
     }
 
-    std::vector<Game*> parents;
-    for (size_t i = 0; i < 2; i++) {
-        game->cloneof[i] = final_game_name(game->dat_no, game->cloneof[i]);
-        if (!game->cloneof[i].empty()) {
-            auto it = games.find(game->cloneof[i]);
-            if (it != games.end()) {
-                auto parent = it->second.get();
-                if (!fix_game(parent, fixing)) {
-                    return false;
-                }
-                parents.push_back(it->second.get());
-                for (size_t j = 0; j < i; j++) {
-                    if (!parent->cloneof[j].empty()) {
-                        if (i + j > 2) {
-                            output.file_info_error(
-                                error_info, "game '{}' has more than 2 ancestors, which is not supported", game->name);
-                            return false;
-                        }
-                        if (game->cloneof[i + j].empty()) {
-                            game->cloneof[i + j] = parent->cloneof[j];
-                        }
-                        else if (game->cloneof[i + j] != parent->cloneof[j]) {
-                            output.file_info_error(error_info,
-                                                   "game '{}' has inconsistent cloneof fields with parent '{}'",
-                                                   game->name, parent->name);
-                            return false;
-                        }
-                    }
-                }
+    return true;
+}
+
+
+bool OutputContext::inherit_ancestors(Game* game, const Game* parent, size_t index) {
+    const auto& error_info = dats[game->dat_no].error_info;
+
+    for (size_t j = 0; j < index; j++) {
+        if (!parent->cloneof[j].empty()) {
+            if (index + j > 2) {
+                output.file_info_error(error_info, "game '{}' has more than 2 ancestors, which is not supported",
+                                       game->name);
+                return false;
             }
-            else {
-                output.file_info_error(error_info, "inconsistency: {} has non-existent parent {}", game->name,
-                                       game->cloneof[i]);
-                game->cloneof[i] = "";
-                parents.push_back(nullptr);
+            if (game->cloneof[index + j].empty()) {
+                game->cloneof[index + j] = parent->cloneof[j];
+            }
+            else if (game->cloneof[index + j] != parent->cloneof[j]) {
+                output.file_info_error(error_info, "game '{}' has inconsistent cloneof fields with parent '{}'",
+                                       game->name, parent->name);
+                return false;
             }
-        }
-        else {
-            parents.push_back(nullptr);
         }
     }
 
+    return true;
+}
+
+
+void OutputContext::finish_fixed_game(Game* game, std::array<GamePtr, 2>& parents) {
+    const auto& error_info = dats[game->dat_no].error_info;
+
     // If parent doesn't exist but grandparent does, move it up to parent.
     if (game->cloneof[0].empty() && !game->cloneof[1].empty()) {
         game->cloneof[0] = game->cloneof[1];
         game->cloneof[1] = "";
-        parents.erase(parents.begin());
+        parents[0] = parents[1];
+        parents[1] = nullptr;
     }
 
     if (!game->cloneof[0].empty()) {
@@ -350,7 +503,9 @@ bool OutputContext::fix_game(Game* game, std::unordered_set<Game*> fixing) {
         }
     }
 
-    return true;
+    if (staging) {
+        staging->update_game(*game);
+    }
 }
 
 
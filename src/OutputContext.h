@@ -34,9 +34,11 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 
 #include "DatEntry.h"
 #include "Detector.h"
@@ -44,6 +46,7 @@
 #include "Hashes.h"
 #include "Output.h"
 #include "SharedFile.h"
+#include "StagingDB.h"
 
 class OutputContext;
 
@@ -106,13 +109,23 @@ class DatOptions {
     /// If set to `true`, use the description as the game name. (default: `false`)
     bool use_description_as_name = false;
 
-    /// A set of game names that should be considered MIA. (default: empty)
-    std::unordered_set<std::string> mia_games;
+    /// A set of game names that should be considered MIA, shared between dats. (default: none)
+    std::shared_ptr<const std::unordered_set<std::string>> mia_games;
+
+    /// Checksum of the list `mia_games` was read from. (default: 0)
+    uint32_t mia_games_checksum = 0;
 
     /// If set to `true`, only the last game with duplicate name will be kept. This is used when creating fixdats.
     /// (default: `false`)
     bool only_last_duplicate = false;
 
+    /**
+     * Get a checksum of the options that affect the games added to RomDB.
+     *
+     * @return The checksum, 0 for default options.
+     */
+    uint32_t checksum() const;
+
     /**
      * Get the suffix to add to all game names.
      *
@@ -126,6 +139,14 @@ class DatOptions {
      * @return The suffix to add to the game name.
      */
     std::string duplicate_name_suffix() const { return suffix_only_duplicates ? game_name_suffix : ""; }
+
+    /**
+     * Check whether a game is listed as MIA.
+     *
+     * @param game_name The name of the game.
+     * @return `true` if the game is MIA.
+     */
+    bool is_mia_game(const std::string& game_name) const { return mia_games && mia_games->contains(game_name); }
 };
 
 /**
@@ -151,7 +172,7 @@ class OutputContext {
   public:
     enum Format { FORMAT_CM, FORMAT_DATAFILE_XML, FORMAT_DB, FORMAT_MTREE };
 
-    virtual ~OutputContext() = default;
+    virtual ~OutputContext();
 
     /**
      * Create a new OutputContext of the given format.
@@ -172,6 +193,12 @@ class OutputContext {
      */
     void add_header_overrides(const DatEntryOverrides& overrides) { header_overrides.merge(overrides); }
 
+    /**
+     * Keep games in a temporary database until `finish()` instead of in memory, so memory use does not grow with the
+     * number of games. Must be called before any dat is started.
+     */
+    void use_staging_database();
+
     /**
      * Add detector for the current dat. This is called by the parser for each detector found in the dat. `start_dat()`
      * must have been called before.
@@ -179,7 +206,7 @@ class OutputContext {
      * @param detector The detector to add.
      * @return `true` on success, `false` on failure.
      */
-    bool add_detector(const Detector& detector);
+    virtual bool add_detector(const Detector& detector);
 
 
     /**
@@ -192,7 +219,7 @@ class OutputContext {
      * @param game The game to add.
      * @return `true` on success, `false` on failure.
      */
-    bool add_game(GamePtr game);
+    virtual bool add_game(GamePtr game);
 
     /**
      * Add a header for the current dat. This is called by the parser once for each dat. `start_dat()` must have been
@@ -201,7 +228,7 @@ class OutputContext {
      * @param dat The header info for the dat.
      * @return `true` on success, `false` on failure.
      */
-    bool add_header(const DatEntry& dat);
+    virtual bool add_header(const DatEntry& dat);
 
     void error_occurred() { ok = false; }
     virtual bool found_game() { return true; }
@@ -220,7 +247,7 @@ class OutputContext {
      * @param file_info The file info for the new dat, used for error reporting.
      * @return `true` on success, `false` on failure.
      */
-    bool start_dat(DatOptions options, Output::FileInfo file_info);
+    virtual bool start_dat(DatOptions options, Output::FileInfo file_info);
 
 
   protected:
@@ -263,6 +290,28 @@ class OutputContext {
         std::strong_ordering operator<=>(const Name& other) const;
     };
 
+    /**
+     * Games sharing a name, with their fingerprints.
+     */
+    class NamedGames {
+      public:
+        std::vector<GamePtr> games;
+        std::vector<uint64_t> fingerprints;
+    };
+
+    /**
+     * Game whose ancestors are being fixed, one entry per level of the cloneof chain walked by `fix_game`.
+     */
+    class FixingGame {
+      public:
+        explicit FixingGame(Game* game) : game(game) {}
+
+        Game* game;
+        std::array<GamePtr, 2> parents;
+        size_t next_parent = 0;
+        bool parent_fixed = false;
+    };
+
     /**
      * Get the final name for a game.
      *
@@ -270,7 +319,7 @@ class OutputContext {
      * @param name The original name of the game.
      * @return The final name of the game.
      */
-    const std::string& final_game_name(size_t dat_no, const std::string& name) const;
+    std::string final_game_name(size_t dat_no, const std::string& name) const;
 
     /**
      * Get the final header information for the created dat.
@@ -285,11 +334,57 @@ class OutputContext {
     /**
      * Fix inconsistencies in the given game and adjust where ROMs are located.
      *
+     * Ancestors are fixed first. The cloneof chain is walked iteratively, so long chains don't exhaust the stack,
+     * and cycles are reported and broken by dropping the parent that closes them.
+     *
      * @param game The game to fix.
-     * @param fixing The set of games currently being fixed, used to detect cycles in cloneof relationships.
      * @return `true` if the game was successfully fixed, `false` if an error occurred.
      */
-    bool fix_game(Game* game, std::unordered_set<Game*> fixing = {});
+    bool fix_game(Game* game);
+
+    /**
+     * Mark game as fixed.
+     *
+     * @param game The game to mark.
+     * @return `true` if the game was not fixed before, `false` if it already was.
+     */
+    bool mark_fixed(Game* game);
+
+    /**
+     * Take over ancestors of a fixed parent.
+     *
+     * @param game The game whose cloneof fields are updated.
+     * @param parent The parent, already fixed.
+     * @param index The index of the parent in `game->cloneof`.
+     * @return `true` on success, `false` if the ancestors are inconsistent.
+     */
+    bool inherit_ancestors(Game* game, const Game* parent, size_t index);
+
+    /**
+     * Adjust where ROMs are located, after all ancestors of the game are fixed.
+     *
+     * @param game The game to finish.
+     * @param parents The ancestors of the game.
+     */
+    void finish_fixed_game(Game* game, std::array<GamePtr, 2>& parents);
+
+    /**
+     * Get game by its final name.
+     *
+     * @param name The final name of the game.
+     * @return The game, or null if there is no game with that name.
+     */
+    GamePtr find_game(const std::string& name) const;
+
+    /**
+     * Give games with the same name unique names.
+     *
+     * @param named_games The games sharing a name, in the order they were added.
+     */
+    void rename_duplicates(const std::vector<GamePtr>& named_games) const;
+
+    /// Delete staging database and its file.
+    void close_staging_database();
 
     /**
      * Get the current dat number. Must not be called if no dat has been started.
@@ -330,7 +425,7 @@ class OutputContext {
     /**
      * Games, grouped by name. Games with the same name will be renamed to avoid duplicates.
      */
-    std::unordered_map<std::string, std::vector<GamePtr>> games_by_name;
+    std::unordered_map<std::string, NamedGames> games_by_name;
 
     /**
      * Map from original game name to renamed game name, used to adjust cloneof fields.
@@ -346,6 +441,12 @@ class OutputContext {
      * Final list of games.
      */
     std::unordered_map<std::string, GamePtr> games;
+
+    /**
+     * Database holding the games instead of the members above, if set.
+     */
+    std::unique_ptr<StagingDB> staging;
+    std::filesystem::path staging_file_name;
 };
 
 #endif // HAD_OUTPUT_CONTEXT_H
@@ -0,0 +1,105 @@
+/*
+  OutputContextBuffer.cc -- collect parsed dat for later replay
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "OutputContextBuffer.h"
+
+#include "globals.h"
+
+
+bool OutputContextBuffer::start_dat(DatOptions options, Output::FileInfo file_info) {
+    events.emplace_back(StartDat{std::move(options), std::move(file_info)});
+    return true;
+}
+
+
+bool OutputContextBuffer::add_header(const DatEntry& dat) {
+    events.emplace_back(dat);
+    return true;
+}
+
+
+bool OutputContextBuffer::add_detector(const Detector& detector) {
+    events.emplace_back(detector);
+    return true;
+}
+
+
+bool OutputContextBuffer::add_game(GamePtr game) {
+    events.emplace_back(std::move(game));
+    return true;
+}
+
+
+void OutputContextBuffer::collect(const std::function<bool(OutputContext*)>& parse) {
+    output.start_capture();
+    try {
+        result = parse(this);
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+    messages = output.end_capture();
+}
+
+
+bool OutputContextBuffer::replay(OutputContext* target) {
+    output.print_captured(messages);
+
+    for (auto& event : events) {
+        auto event_ok = true;
+        if (auto start = std::get_if<StartDat>(&event)) {
+            event_ok = target->start_dat(std::move(start->options), std::move(start->file_info));
+        }
+        else if (auto dat = std::get_if<DatEntry>(&event)) {
+            event_ok = target->add_header(*dat);
+        }
+        else if (auto detector = std::get_if<Detector>(&event)) {
+            event_ok = target->add_detector(*detector);
+        }
+        else {
+            event_ok = target->add_game(std::move(std::get<GamePtr>(event)));
+        }
+        if (!event_ok) {
+            result = false;
+        }
+    }
+    events.clear();
+
+    if (!ok) {
+        target->error_occurred();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    return result;
+}
@@ -0,0 +1,91 @@
+#ifndef HAD_OUTPUT_CONTEXT_BUFFER_H
+#define HAD_OUTPUT_CONTEXT_BUFFER_H
+
+/*
+  OutputContextBuffer.h -- collect parsed dat for later replay
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <exception>
+#include <functional>
+#include <variant>
+#include <vector>
+
+#include "OutputContext.h"
+
+/**
+ * OutputContextBuffer records everything a parser passes to it, so dats can be parsed on worker threads and passed on
+ * to the real output context in the order they would have been parsed serially. This gives the same result as parsing
+ * directly into the real output context.
+ */
+class OutputContextBuffer : public OutputContext {
+  public:
+    bool start_dat(DatOptions options, Output::FileInfo file_info) override;
+    bool add_header(const DatEntry& dat) override;
+    bool add_detector(const Detector& detector) override;
+    bool add_game(GamePtr game) override;
+
+    /**
+     * Call `parse` with this buffer as output context, capturing messages printed by the current thread. Exceptions
+     * thrown by `parse` are kept and rethrown by `replay()`.
+     *
+     * @param parse The function that parses into the given output context.
+     */
+    void collect(const std::function<bool(OutputContext*)>& parse);
+
+    /**
+     * Print the captured messages and pass the recorded information on to `target`.
+     *
+     * @param target The output context to pass the recorded information to.
+     * @return The return value of the parse function.
+     * @throw The exception thrown by the parse function, after passing on what was recorded before it was thrown.
+     */
+    bool replay(OutputContext* target);
+
+  protected:
+    bool write_game(const GamePtr game) override { return true; }
+
+  private:
+    class StartDat {
+      public:
+        DatOptions options;
+        Output::FileInfo file_info;
+    };
+
+    typedef std::variant<StartDat, DatEntry, Detector, GamePtr> Event;
+
+    std::vector<Event> events;
+    std::vector<Output::CapturedMessage> messages;
+    std::exception_ptr exception;
+    bool result = false;
+};
+
+#endif // HAD_OUTPUT_CONTEXT_BUFFER_H
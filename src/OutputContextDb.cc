@@ -36,6 +36,8 @@
 #include <algorithm>
 #include <filesystem>
 
+#include "Exception.h"
+#include "RomDBSnapshot.h"
 #include "file_util.h"
 #include "globals.h"
 
@@ -47,6 +49,39 @@ struct fbh_context {
 
 
 OutputContextDb::OutputContextDb(const std::filesystem::path& file_name) : file_name(file_name) {
+    make_temp_file_name();
+
+    db = std::make_unique<RomDB>(temp_file_name, DBH_NEW);
+}
+
+
+OutputContextDb::OutputContextDb(const std::filesystem::path& file_name, const std::filesystem::path& base_file_name)
+    : file_name(file_name), updating(true) {
+    make_temp_file_name();
+
+    std::filesystem::copy_file(base_file_name, temp_file_name);
+    try {
+        db = std::make_unique<RomDB>(temp_file_name, DBH_WRITE);
+
+        db->read_games(base_games);
+        for (const auto& game : base_games) {
+            base_games_by_name[game.name] = &game;
+        }
+
+        if (sqlite3_exec(db->db, "begin transaction", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw Exception("can't start transaction: {}", db->error());
+        }
+    }
+    catch (...) {
+        db = nullptr;
+        std::error_code ec;
+        std::filesystem::remove(temp_file_name, ec);
+        throw;
+    }
+}
+
+
+void OutputContextDb::make_temp_file_name() {
     temp_file_name = file_name.string() + "-mkmamedb";
     if (configuration.use_temp_directory) {
         auto tmpdir = getenv("TMPDIR");
@@ -55,8 +90,32 @@ OutputContextDb::OutputContextDb(const std::filesystem::path& file_name) : file_
         temp_file_name = std::filesystem::path(tmpdir ? tmpdir : "/tmp") / temp_file_name.filename();
     }
     temp_file_name = make_unique_path(temp_file_name);
+}
 
-    db = std::make_unique<RomDB>(temp_file_name, DBH_NEW);
+
+/*
+ * Check whether a game from the database being updated can be kept as is. Only fields stored in the database are
+ * compared.
+ */
+static bool is_unchanged(const Game& base_game, const Game& game) {
+    if (base_game.description != game.description || base_game.dat_no != game.dat_no ||
+        base_game.cloneof[0] != game.cloneof[0]) {
+        return false;
+    }
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        if (base_game.files[ft].size() != game.files[ft].size()) {
+            return false;
+        }
+        for (size_t i = 0; i < game.files[ft].size(); i++) {
+            const auto& base_file = base_game.files[ft][i];
+            const auto& file = game.files[ft][i];
+            // Rom::operator== treats missing hashes as matching.
+            if (base_file != file || base_file.hashes != file.hashes || base_file.hashes.size != file.hashes.size) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 
@@ -71,12 +130,49 @@ OutputContextDb::~OutputContextDb() {
 
 bool OutputContextDb::close() {
     if (db) {
-        db->init2();
+        if (updating) {
+            if (ok) {
+                for (const auto& game : base_games) {
+                    if (!written_games.contains(game.name)) {
+                        db->delete_game(game.name);
+                    }
+                }
+            }
+            if (sqlite3_exec(db->db, ok ? "commit" : "rollback", nullptr, nullptr, nullptr) != SQLITE_OK) {
+                output.error("can't finish transaction: {}", db->error());
+                ok = false;
+            }
+        }
+        else {
+            db->init2();
+        }
+
+        std::vector<uint8_t> snapshot;
+        if (ok && configuration.database_snapshot) {
+            try {
+                snapshot = RomDBSnapshot::compile(db.get());
+            }
+            catch (const Exception& e) {
+                output.error("can't compile snapshot of '{}': {}", file_name, e.what());
+            }
+        }
 
         db = nullptr;
 
         if (ok) { // TODO: and no previous errors
             rename_or_move(temp_file_name, file_name);
+            if (snapshot.empty()) {
+                RomDBSnapshot::remove(file_name);
+            }
+            else {
+                try {
+                    RomDBSnapshot::write(file_name, std::move(snapshot));
+                }
+                catch (const Exception& e) {
+                    output.error("{}", e.what());
+                    RomDBSnapshot::remove(file_name);
+                }
+            }
         }
         else {
             std::filesystem::remove(temp_file_name);
@@ -95,6 +191,16 @@ bool OutputContextDb::write_detector(const Detector& detector) {
 
 
 bool OutputContextDb::write_game(const GamePtr game) {
+    if (updating) {
+        auto it = base_games_by_name.find(game->name);
+        if (it != base_games_by_name.end()) {
+            written_games.insert(it->first);
+            if (is_unchanged(*it->second, *game)) {
+                return true;
+            }
+        }
+    }
+
     db->write_game(game.get());
 
     return true;
@@ -105,6 +211,9 @@ bool OutputContextDb::write_header(const DatEntry& entry) { return true; }
 
 
 bool OutputContextDb::write_dat(size_t index, const DatEntry& entry) {
+    if (updating) {
+        db->delete_dat(index);
+    }
     db->write_dat(index, entry);
 
     return true;
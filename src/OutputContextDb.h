@@ -34,6 +34,11 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "OutputContext.h"
 #include "RomDB.h"
 
@@ -41,6 +46,17 @@
 class OutputContextDb : public OutputContext {
   public:
     OutputContextDb(const std::filesystem::path& file_name);
+
+    /**
+     * Create output context that updates an existing ROM database.
+     *
+     * A copy of the existing database is modified: games that are unchanged are kept, all others are rewritten or
+     * removed.
+     *
+     * @param file_name The file name to write to.
+     * @param base_file_name The ROM database to update.
+     */
+    OutputContextDb(const std::filesystem::path& file_name, const std::filesystem::path& base_file_name);
     ~OutputContextDb() override;
 
     bool close() override;
@@ -51,11 +67,22 @@ class OutputContextDb : public OutputContext {
 
     RomDB* get_db() const { return db.get(); }
 
+    /// Games in the ROM database being updated, in the order they were written. Empty if creating a new database.
+    const std::deque<Game>& get_base_games() const { return base_games; }
+
   private:
     std::filesystem::path file_name;
     std::filesystem::path temp_file_name;
 
     std::unique_ptr<RomDB> db;
+
+    bool updating = false;
+    std::deque<Game> base_games;
+    std::unordered_map<std::string_view, const Game*> base_games_by_name;
+    /// Names of games from `base_games` that are in the updated database.
+    std::unordered_set<std::string_view> written_games;
+
+    void make_temp_file_name();
 };
 
 #endif // HAD_OUTPUT_DB_H
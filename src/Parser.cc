@@ -44,6 +44,7 @@
 
 #include "ParserCm.h"
 #include "ParserRc.h"
+#include "ParserSourceCompressed.h"
 #include "ParserXml.h"
 #include "globals.h"
 #include "util.h"
@@ -89,8 +90,13 @@ std::string Parser::state_name(parser_state_t state) {
     return "invalid";
 }
 
-ParserPtr Parser::create(const ParserSourcePtr& source, const std::unordered_set<std::string>& exclude,
+ParserPtr Parser::create(const ParserSourcePtr& source_, const std::unordered_set<std::string>& exclude,
                          OutputContext* output_context, const DatOptions& options) {
+    auto source = source_;
+    if (auto compression = ParserSourceCompressed::detect(source.get())) {
+        source = std::make_shared<ParserSourceCompressed>(source, *compression);
+    }
+
     size_t length = 0;
     for (const auto& pair : format_start) {
         length = std::max(pair.first.length(), length);
@@ -202,7 +208,7 @@ bool Parser::file_end(filetype_t ft) {
 }
 
 
-bool Parser::file_status(filetype_t ft, const std::string& attr) {
+bool Parser::file_status(filetype_t ft, std::string_view attr) {
     Rom::Status status;
 
     CHECK_STATE(PARSE_IN_FILE);
@@ -228,7 +234,7 @@ bool Parser::file_status(filetype_t ft, const std::string& attr) {
 }
 
 
-bool Parser::file_hash(filetype_t ft, int ht, const std::string& attr) {
+bool Parser::file_hash(filetype_t ft, int ht, std::string_view attr) {
     Hashes* h;
 
     CHECK_STATE(PARSE_IN_FILE);
@@ -270,7 +276,7 @@ bool Parser::file_ignore(filetype_t ft) {
 }
 
 
-bool Parser::file_merge(filetype_t ft, const std::string& attr) {
+bool Parser::file_merge(filetype_t ft, std::string_view attr) {
     CHECK_STATE(PARSE_IN_FILE);
 
     r[ft]->merge = attr;
@@ -297,7 +303,7 @@ bool Parser::file_mtime(filetype_t ft, time_t mtime) {
 }
 
 
-bool Parser::file_name(filetype_t ft, const std::string& attr) {
+bool Parser::file_name(filetype_t ft, std::string_view attr) {
     CHECK_STATE(PARSE_IN_FILE);
 
     if (ft == TYPE_ROM) {
@@ -316,10 +322,10 @@ bool Parser::file_name(filetype_t ft, const std::string& attr) {
 }
 
 
-bool Parser::file_size(filetype_t ft, const std::string& attr) {
+bool Parser::file_size(filetype_t ft, std::string_view attr) {
     /* TODO: check for strol errors */
     try {
-        return file_size(ft, std::stoull(attr, nullptr, 0));
+        return file_size(ft, std::stoull(std::string(attr), nullptr, 0));
     }
     catch (...) {
         output.line_error(lineno, "invalid size '{}'", attr);
@@ -349,7 +355,7 @@ bool Parser::file_start(filetype_t ft) {
 }
 
 
-bool Parser::game_cloneof(const std::string& attr) {
+bool Parser::game_cloneof(std::string_view attr) {
     CHECK_STATE(PARSE_IN_GAME);
 
     g->cloneof[0] = attr;
@@ -358,13 +364,13 @@ bool Parser::game_cloneof(const std::string& attr) {
 }
 
 
-bool Parser::game_description(const std::string& attr) {
+bool Parser::game_description(std::string_view attr) {
     CHECK_STATE(PARSE_IN_GAME);
 
     g->description = attr;
 
     if (options.use_description_as_name) {
-        set_game_name(attr);
+        set_game_name(std::string(attr));
     }
 
     return true;
@@ -389,7 +395,7 @@ bool Parser::game_end() {
             g->cloneof[0] = "";
         }
 
-        if (options.mia_games.contains(g->name)) {
+        if (options.is_mia_game(g->name)) {
             // TODO: disks
             for (auto& rom : g->files[TYPE_ROM]) {
                 if (!configuration.delete_unknown_pattern.empty() &&
@@ -410,11 +416,11 @@ bool Parser::game_end() {
 }
 
 
-bool Parser::game_name(const std::string& attr) {
+bool Parser::game_name(std::string_view attr) {
     CHECK_STATE(PARSE_IN_GAME);
 
     if (!options.use_description_as_name) {
-        set_game_name(attr);
+        set_game_name(std::string(attr));
     }
     g->original_name = attr;
 
@@ -469,7 +475,7 @@ bool Parser::game_start() {
 }
 
 
-bool Parser::prog_description(const std::string& attr) {
+bool Parser::prog_description(std::string_view attr) {
     CHECK_STATE(PARSE_IN_HEADER);
 
     de.description = attr;
@@ -479,7 +485,7 @@ bool Parser::prog_description(const std::string& attr) {
 }
 
 
-bool Parser::prog_header(const std::string& attr) {
+bool Parser::prog_header(std::string_view attr) {
     CHECK_STATE(PARSE_IN_HEADER);
 
     if (detector) {
@@ -493,7 +499,7 @@ bool Parser::prog_header(const std::string& attr) {
 
     auto ok = true;
 
-    ParserSourcePtr dps = ps->open(attr);
+    ParserSourcePtr dps = ps->open(std::string(attr));
     if (!dps) {
         output.line_error_system(lineno, "cannot open detector '{}'", attr);
         error = true;
@@ -516,7 +522,7 @@ bool Parser::prog_header(const std::string& attr) {
 }
 
 
-bool Parser::prog_name(const std::string& attr) {
+bool Parser::prog_name(std::string_view attr) {
     CHECK_STATE(PARSE_IN_HEADER);
 
     de.name = attr;
@@ -526,7 +532,7 @@ bool Parser::prog_name(const std::string& attr) {
 }
 
 
-bool Parser::prog_version(const std::string& attr) {
+bool Parser::prog_version(std::string_view attr) {
     CHECK_STATE(PARSE_IN_HEADER);
 
     de.version = attr;
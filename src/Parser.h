@@ -34,6 +34,7 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <string_view>
 #include <unordered_set>
 
 #include "DatEntry.h"
@@ -86,25 +87,25 @@ class Parser {
     void eof();
     bool file_continue(filetype_t ft);
     bool file_end(filetype_t ft);
-    bool file_status(filetype_t ft, const std::string& attr);
-    bool file_hash(filetype_t ft, int ht, const std::string& attr);
+    bool file_status(filetype_t ft, std::string_view attr);
+    bool file_hash(filetype_t ft, int ht, std::string_view attr);
     bool file_ignore(filetype_t ft);
-    bool file_merge(filetype_t ft, const std::string& attr);
+    bool file_merge(filetype_t ft, std::string_view attr);
     bool file_missing(filetype_t ft, bool attr);
     bool file_mtime(filetype_t ft, time_t mtime);
-    bool file_name(filetype_t ft, const std::string& attr);
-    bool file_size(filetype_t ft, const std::string& attr);
+    bool file_name(filetype_t ft, std::string_view attr);
+    bool file_size(filetype_t ft, std::string_view attr);
     bool file_size(filetype_t ft, uint64_t size);
     bool file_start(filetype_t ft);
-    bool game_cloneof(const std::string& attr);
-    bool game_description(const std::string& attr);
+    bool game_cloneof(std::string_view attr);
+    bool game_description(std::string_view attr);
     bool game_end();
-    bool game_name(const std::string& attr);
+    bool game_name(std::string_view attr);
     bool game_start();
-    bool prog_description(const std::string& attr);
-    bool prog_header(const std::string& attr);
-    bool prog_name(const std::string& attr);
-    bool prog_version(const std::string& attr);
+    bool prog_description(std::string_view attr);
+    bool prog_header(std::string_view attr);
+    bool prog_name(std::string_view attr);
+    bool prog_version(std::string_view attr);
 
     Parser(ParserSourcePtr source, std::unordered_set<std::string> exclude, OutputContext* output_,
            const DatOptions& options);
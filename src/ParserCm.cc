@@ -36,17 +36,72 @@
 #include "globals.h"
 
 
+const std::unordered_map<std::string_view, ParserCm::CommandCallback> ParserCm::top_commands = {
+    {"BEGIN", cmd_ignore}, // TODO: beginning/end of file, ignored for now
+    {"END", cmd_ignore},
+    {"clrmamepro", cmd_prog_start},
+    {"emulator", cmd_prog_start},
+    {"game", cmd_game_start}, // game/resource for MAME/Raine, machine for MESS
+    {"machine", cmd_game_start},
+    {"resource", cmd_game_start}};
+
+const std::unordered_map<std::string_view, ParserCm::CommandCallback> ParserCm::game_commands = {
+    {")", cmd_game_end},
+    {"archive", cmd_ignore}, // TODO: archive names
+    {"description", cmd_game_description},
+    {"disk", cmd_disk},
+    {"manufacturer", cmd_skip_value},
+    {"name", cmd_game_name},
+    {"rom", cmd_rom},
+    {"romof", cmd_game_cloneof},
+    {"sample", cmd_skip_value},
+    {"sampleof", cmd_skip_value},
+    {"sourcefile", cmd_skip_value},
+    {"year", cmd_skip_value}};
+
+const std::unordered_map<std::string_view, ParserCm::CommandCallback> ParserCm::prog_commands = {
+    {")", cmd_prog_end},
+    {"author", cmd_skip_value},
+    {"category", cmd_skip_value},
+    {"comment", cmd_skip_value},
+    {"date", cmd_skip_value},
+    {"description", cmd_prog_description},
+    {"forcemerging", cmd_skip_value},
+    {"forcenodump", cmd_skip_value},
+    {"forcepacking", cmd_skip_value},
+    {"header", cmd_prog_header},
+    {"name", cmd_prog_name},
+    {"version", cmd_prog_version}};
+
+const std::unordered_map<std::string_view, ParserCm::FileAttribute> ParserCm::rom_attributes = {
+    {"baddump", FileAttribute("", file_attribute_status)},
+    {"crc", FileAttribute("crc", file_attribute_hash, Hashes::TYPE_CRC)},
+    {"crc32", FileAttribute("crc", file_attribute_hash, Hashes::TYPE_CRC)},
+    {"flags", FileAttribute("flags", file_attribute_status)},
+    {"md5", FileAttribute("md5", file_attribute_hash, Hashes::TYPE_MD5)},
+    {"merge", FileAttribute("merge", file_attribute_merge)},
+    {"nodump", FileAttribute("", file_attribute_status)},
+    {"sha1", FileAttribute("sha1", file_attribute_hash, Hashes::TYPE_SHA1)},
+    {"size", FileAttribute("size", file_attribute_size)}};
+
+const std::unordered_map<std::string_view, ParserCm::FileAttribute> ParserCm::disk_attributes = {
+    {"flags", FileAttribute("flags", file_attribute_status)},
+    {"md5", FileAttribute("md5", file_attribute_hash, Hashes::TYPE_MD5)},
+    {"merge", FileAttribute("merge", file_attribute_merge)},
+    {"sha1", FileAttribute("sha1", file_attribute_hash, Hashes::TYPE_SHA1)}};
+
+
 bool ParserCm::parse() {
     auto ok = true;
     lineno = 0;
-    auto parse_state = TOP;
+    parse_state = TOP;
 
-    std::optional<std::string> line;
+    std::optional<std::span<char>> line;
 
     while (!end_parsing && (line = ps->getline()).has_value()) {
         lineno++;
 
-        auto tokenizer = Tokenizer(line.value());
+        auto tokenizer = Tokenizer(line->data(), line->size());
 
         auto cmd = tokenizer.get();
 
@@ -56,265 +111,31 @@ bool ParserCm::parse() {
 
         ignoring_line = false;
 
+        const std::unordered_map<std::string_view, CommandCallback>* commands;
         switch (parse_state) {
         case TOP:
-            /* game/resource for MAME/Raine, machine for MESS */
-            if (cmd == "game" || cmd == "machine" || cmd == "resource") {
-                game_start();
-                parse_state = GAME;
-                auto brace = tokenizer.get();
-                if (brace != "(") {
-                    output.line_error(lineno, "expected '(', got '{}'", brace);
-                    ok = false;
-                    break;
-                }
-            }
-            else if (cmd == "emulator" || cmd == "clrmamepro") {
-                parse_state = PROG;
-                auto brace = tokenizer.get();
-                if (brace != "(") {
-                    output.line_error(lineno, "expected '(', got '{}'", brace);
-                    ok = false;
-                    break;
-                }
-            }
-            else if (cmd == "BEGIN" || cmd == "END") {
-                /* TODO: beginning/end of file, ignored for now */
-            }
-            else {
-                warn_unknown_keyword(cmd);
-                ignoring_line = true;
-            }
+            commands = &top_commands;
             break;
-
         case GAME:
-            if (cmd == "name") {
-                game_name(tokenizer.get());
-            }
-            else if (cmd == "description") {
-                game_description(tokenizer.get());
-            }
-            else if (cmd == "romof") {
-                game_cloneof(tokenizer.get());
-            }
-            else if (cmd == "sampleof" || cmd == "sourcefile") {
-                /* skip value */
-                tokenizer.get();
-            }
-            else if (cmd == "rom") {
-                auto brace = tokenizer.get();
-                if (brace != "(") {
-                    output.line_error(lineno, "expected '(', got '{}'", brace);
-                    ok = false;
-                    break;
-                }
-                auto name = tokenizer.get();
-                if (name != "name") {
-                    output.line_error(lineno, "expected 'name', got '{}'", name);
-                    ok = false;
-                    break;
-                }
-                file_start(TYPE_ROM);
-                file_name(TYPE_ROM, tokenizer.get());
-
-                /* read remaining tokens and look for known tokens */
-                std::string token;
-                while (!(token = tokenizer.get()).empty()) {
-                    if (token == "baddump" || token == "nodump") {
-                        if (!file_status(TYPE_ROM, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "crc" || token == "crc32") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token crc missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_hash(TYPE_ROM, Hashes::TYPE_CRC, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "flags") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token flags missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_status(TYPE_ROM, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "merge") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token merge missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_merge(TYPE_ROM, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "md5") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token md5 missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_hash(TYPE_ROM, Hashes::TYPE_MD5, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "sha1") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token sha1 missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_hash(TYPE_ROM, Hashes::TYPE_SHA1, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "size") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token size missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_size(TYPE_ROM, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == ")") {
-                        break;
-                    }
-                    else {
-                        output.line_error(lineno, "warning: ignoring unknown token '{}'", token);
-                    }
-                }
-
-                file_end(TYPE_ROM);
-            }
-            else if (cmd == "disk") {
-                auto brace = tokenizer.get();
-                if (brace != "(") {
-                    output.line_error(lineno, "expected '(', got '{}'", brace);
-                    ok = false;
-                    break;
-                }
-                auto name = tokenizer.get();
-                //                    if (tokenizer.get() != "name") {
-                if (name != "name") {
-                    output.line_error(lineno, "expected token 'name' not found ('{}', '{}')", brace, name);
-                    ok = false;
-                    break;
-                }
-
-                file_start(TYPE_DISK);
-                file_name(TYPE_DISK, tokenizer.get());
-
-                /* read remaining tokens and look for known tokens */
-                std::string token;
-                while (!(token = tokenizer.get()).empty()) {
-                    if (token == "sha1") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token sha1 missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_hash(TYPE_DISK, Hashes::TYPE_SHA1, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "md5") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token md5 missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_hash(TYPE_DISK, Hashes::TYPE_MD5, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "merge") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token merge missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_merge(TYPE_DISK, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == "flags") {
-                        if ((token = tokenizer.get()).empty()) {
-                            output.line_error(lineno, "token flags missing argument");
-                            ok = false;
-                            continue;
-                        }
-                        if (!file_status(TYPE_DISK, token)) {
-                            continue;
-                        }
-                    }
-                    else if (token == ")") {
-                        break;
-                    }
-                    else {
-                        warn_unknown_keyword(token);
-                    }
-                }
-                file_end(TYPE_DISK);
-            }
-            else if (cmd == "archive") {
-                /* TODO: archive names */
-            }
-            else if (cmd == "sample") {
-                /* skip value */
-                tokenizer.get();
-            }
-            else if (cmd == ")") {
-                game_end();
-                parse_state = TOP;
-            }
-            else if (cmd == "manufacturer" || cmd == "year") {
-                /* skip value */
-                tokenizer.get();
-            }
-            else {
-                warn_unknown_keyword(cmd);
-            }
+            commands = &game_commands;
             break;
-
         case PROG:
-            if (cmd == "name") {
-                prog_name(tokenizer.get());
-            }
-            else if (cmd == "description") {
-                prog_description(tokenizer.get());
-            }
-            else if (cmd == "version") {
-                prog_version(tokenizer.get());
-            }
-            else if (cmd == "header") {
-                prog_header(tokenizer.get());
-            }
-            else if (cmd == ")") {
-                // TODO: this shouldn't be necessary
-                header_end();
-                parse_state = TOP;
-            }
-            else if (cmd == "author" || cmd == "category" || cmd == "comment" || cmd == "date" ||
-                     cmd == "forcemerging" || cmd == "forcenodump" || cmd == "forcepacking") {
-                /* skip value */
-                tokenizer.get();
-            }
-            else {
-                warn_unknown_keyword(cmd);
-            }
+            commands = &prog_commands;
             break;
         }
+
+        auto it = commands->find(cmd);
+        if (it != commands->end()) {
+            if (!it->second(this, &tokenizer)) {
+                ok = false;
+            }
+        }
+        else {
+            warn_unknown_keyword(cmd);
+        }
+
         if (!ignoring_line) {
-            std::string leftover = tokenizer.get();
+            auto leftover = tokenizer.get();
             while (!leftover.empty()) {
                 output.line_error(lineno, "ignoring unknown token '{}'", leftover);
                 leftover = tokenizer.get();
@@ -326,87 +147,240 @@ bool ParserCm::parse() {
 }
 
 
-std::string ParserCm::Tokenizer::get() {
-    if (position == std::string::npos) {
-        return "";
+bool ParserCm::expect_open_brace(Tokenizer* tokenizer) {
+    auto brace = tokenizer->get();
+    if (brace != "(") {
+        output.line_error(lineno, "expected '(', got '{}'", brace);
+        return false;
     }
+    return true;
+}
 
-    auto s = string.find_first_not_of(" \t", position);
-    if (s == std::string::npos) {
-        position = std::string::npos;
-        return "";
+
+bool ParserCm::parse_file(Tokenizer* tokenizer, filetype_t file_type) {
+    auto brace = tokenizer->get();
+    if (brace != "(") {
+        output.line_error(lineno, "expected '(', got '{}'", brace);
+        return false;
+    }
+    auto name = tokenizer->get();
+    if (name != "name") {
+        if (file_type == TYPE_ROM) {
+            output.line_error(lineno, "expected 'name', got '{}'", name);
+        }
+        else {
+            output.line_error(lineno, "expected token 'name' not found ('{}', '{}')", brace, name);
+        }
+        return false;
     }
 
-    size_t e;
+    file_start(file_type);
+    file_name(file_type, tokenizer->get());
 
-    switch (string[s]) {
-    case '\0':
-    case '\n':
-    case '\r':
-        position = std::string::npos;
-        return "";
-
-    case '\"':
-        s++;
-        e = string.find_first_of("\\\"", s);
-        if (e == std::string::npos) {
-            // TODO: treat missing closing quote as error?
+    /* read remaining tokens and look for known tokens */
+    const auto& attributes = file_type == TYPE_ROM ? rom_attributes : disk_attributes;
+    auto ok = true;
+    std::string_view token;
+    while (!(token = tokenizer->get()).empty()) {
+        if (token == ")") {
             break;
         }
-        if (string[e] == '\\') {
-            std::string token = string.substr(s, e - s);
 
-            while (string[e] == '\\') {
-                switch (string[e + 1]) {
-                case '\0':
-                    // TODO: treat trailing \\ as error?
-                    token += '\\';
-                    position = std::string::npos;
-                    return token;
+        auto it = attributes.find(token);
+        if (it == attributes.end()) {
+            if (file_type == TYPE_ROM) {
+                output.line_error(lineno, "warning: ignoring unknown token '{}'", token);
+            }
+            else {
+                warn_unknown_keyword(token);
+            }
+            continue;
+        }
 
-                    // TODO: other C style escapes like \n?
+        const auto& attribute = it->second;
+        if (!attribute.argument_name.empty()) {
+            if ((token = tokenizer->get()).empty()) {
+                output.line_error(lineno, "token {} missing argument", attribute.argument_name);
+                ok = false;
+                continue;
+            }
+        }
+        // Errors in values are reported by Parser, parsing continues.
+        attribute.cb(this, file_type, attribute.hash_type, token);
+    }
 
-                default:
-                    token += string[e + 1];
-                }
+    file_end(file_type);
+    return ok;
+}
+
+
+bool ParserCm::cmd_disk(ParserCm* parser, Tokenizer* tokenizer) { return parser->parse_file(tokenizer, TYPE_DISK); }
+
+
+bool ParserCm::cmd_game_cloneof(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->game_cloneof(tokenizer->get());
+    return true;
+}
+
+
+bool ParserCm::cmd_game_description(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->game_description(tokenizer->get());
+    return true;
+}
+
+
+bool ParserCm::cmd_game_end(ParserCm* parser, [[maybe_unused]] Tokenizer* tokenizer) {
+    parser->game_end();
+    parser->parse_state = TOP;
+    return true;
+}
+
+
+bool ParserCm::cmd_game_name(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->game_name(tokenizer->get());
+    return true;
+}
+
+
+bool ParserCm::cmd_game_start(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->game_start();
+    parser->parse_state = GAME;
+    return parser->expect_open_brace(tokenizer);
+}
+
+
+bool ParserCm::cmd_ignore([[maybe_unused]] ParserCm* parser, [[maybe_unused]] Tokenizer* tokenizer) { return true; }
+
+
+bool ParserCm::cmd_prog_description(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->prog_description(tokenizer->get());
+    return true;
+}
+
+
+bool ParserCm::cmd_prog_end(ParserCm* parser, [[maybe_unused]] Tokenizer* tokenizer) {
+    // TODO: this shouldn't be necessary
+    parser->header_end();
+    parser->parse_state = TOP;
+    return true;
+}
+
+
+bool ParserCm::cmd_prog_header(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->prog_header(tokenizer->get());
+    return true;
+}
+
+
+bool ParserCm::cmd_prog_name(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->prog_name(tokenizer->get());
+    return true;
+}
+
+
+bool ParserCm::cmd_prog_start(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->parse_state = PROG;
+    return parser->expect_open_brace(tokenizer);
+}
 
-                e += 2;
 
-                auto next = string.find_first_of("\\\"", e);
-                if (next == std::string::npos) {
-                    // TODO: treat missing closing " as error?
-                    position = next;
-                    token += string.substr(e);
-                    return token;
+bool ParserCm::cmd_prog_version(ParserCm* parser, Tokenizer* tokenizer) {
+    parser->prog_version(tokenizer->get());
+    return true;
+}
+
+
+bool ParserCm::cmd_rom(ParserCm* parser, Tokenizer* tokenizer) { return parser->parse_file(tokenizer, TYPE_ROM); }
+
+
+bool ParserCm::cmd_skip_value([[maybe_unused]] ParserCm* parser, Tokenizer* tokenizer) {
+    tokenizer->get();
+    return true;
+}
+
+
+bool ParserCm::file_attribute_hash(ParserCm* parser, filetype_t file_type, int hash_type, std::string_view value) {
+    return parser->file_hash(file_type, hash_type, value);
+}
+
+
+bool ParserCm::file_attribute_merge(ParserCm* parser, filetype_t file_type, [[maybe_unused]] int hash_type,
+                                    std::string_view value) {
+    return parser->file_merge(file_type, value);
+}
+
+
+bool ParserCm::file_attribute_size(ParserCm* parser, filetype_t file_type, [[maybe_unused]] int hash_type,
+                                   std::string_view value) {
+    return parser->file_size(file_type, value);
+}
+
+
+bool ParserCm::file_attribute_status(ParserCm* parser, filetype_t file_type, [[maybe_unused]] int hash_type,
+                                     std::string_view value) {
+    return parser->file_status(file_type, value);
+}
+
+
+std::string_view ParserCm::Tokenizer::get() {
+    while (current < end && (*current == ' ' || *current == '\t')) {
+        current++;
+    }
+    if (current == end) {
+        return {};
+    }
+
+    switch (*current) {
+    case '\0':
+    case '\n':
+    case '\r':
+        current = end;
+        return {};
+
+    case '\"': {
+        current++;
+        auto start = current;
+        auto unescaped = current;
+        while (current < end) {
+            if (*current == '\"') {
+                current++;
+                return {start, static_cast<size_t>(unescaped - start)};
+            }
+            if (*current == '\\') {
+                if (current + 1 == end) {
+                    // TODO: treat trailing \\ as error?
+                    *(unescaped++) = '\\';
+                    current = end;
+                    break;
                 }
-                token += string.substr(e, next - e);
-                e = next;
+                // TODO: other C style escapes like \n?
+                current++;
             }
-            position = e + 1;
-            return token;
+            *(unescaped++) = *(current++);
         }
-        break;
-
-    default:
-        e = string.find_first_of(" \t\n\r", s);
-        break;
+        // TODO: treat missing closing quote as error?
+        return {start, static_cast<size_t>(unescaped - start)};
     }
 
-    if (e == std::string::npos) {
-        e = string.size();
+    default: {
+        auto start = current;
+        while (current < end && *current != ' ' && *current != '\t' && *current != '\n' && *current != '\r') {
+            current++;
+        }
+        auto token = std::string_view(start, static_cast<size_t>(current - start));
+        if (current < end) {
+            current++;
+        }
+        return token;
     }
-    position = e;
-    if (string[position] != '\0') {
-        position++;
     }
-
-    return string.substr(s, e - s);
 }
 
-void ParserCm::warn_unknown_keyword(const std::string& keyword) {
-    if (warned_keywords.find(keyword) == warned_keywords.end()) {
+
+void ParserCm::warn_unknown_keyword(std::string_view keyword) {
+    auto [it, inserted] = warned_keywords.emplace(keyword);
+    if (inserted) {
         output.line_error(lineno, "unexpected token '{}'", keyword);
-        warned_keywords.insert(keyword);
     }
     ignoring_line = true;
 }
@@ -36,6 +36,8 @@
 
 #include "Parser.h"
 
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
@@ -44,26 +46,76 @@ class ParserCm : public Parser {
     bool parse() override;
 
     ParserCm(ParserSourcePtr source, const std::unordered_set<std::string>& exclude, OutputContext* output, const DatOptions& options)
-        : Parser(std::move(source), exclude, output, options), ignoring_line(false) {}
+        : Parser(std::move(source), exclude, output, options), ignoring_line(false), parse_state(TOP) {}
     ~ParserCm() override = default;
 
   private:
     enum State { TOP, GAME, PROG };
 
+    /**
+     * Split line into tokens. Tokens point into the line, quoted tokens are unescaped in place.
+     */
     class Tokenizer {
       public:
-        explicit Tokenizer(std::string s) : string(std::move(s)), position(0) {}
+        Tokenizer(char* data, size_t length) : current(data), end(data + length) {}
 
-        std::string get();
+        /// Get next token, empty at end of line.
+        std::string_view get();
 
       private:
-        std::string string;
-        size_t position;
+        char* current;
+        char* end;
     };
 
+    typedef bool (*CommandCallback)(ParserCm* parser, Tokenizer* tokenizer);
+    typedef bool (*FileAttributeCallback)(ParserCm* parser, filetype_t file_type, int hash_type,
+                                          std::string_view value);
+
+    class FileAttribute {
+      public:
+        FileAttribute(std::string_view argument_name_, FileAttributeCallback cb_, int hash_type_ = 0)
+            : argument_name(argument_name_), cb(cb_), hash_type(hash_type_) {}
+
+        // Name used in error messages, empty if the keyword itself is the value.
+        std::string_view argument_name;
+        FileAttributeCallback cb;
+        int hash_type;
+    };
+
+    static const std::unordered_map<std::string_view, CommandCallback> top_commands;
+    static const std::unordered_map<std::string_view, CommandCallback> game_commands;
+    static const std::unordered_map<std::string_view, CommandCallback> prog_commands;
+    static const std::unordered_map<std::string_view, FileAttribute> rom_attributes;
+    static const std::unordered_map<std::string_view, FileAttribute> disk_attributes;
+
+    static bool cmd_disk(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_game_cloneof(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_game_description(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_game_end(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_game_name(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_game_start(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_ignore(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_prog_description(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_prog_end(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_prog_header(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_prog_name(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_prog_start(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_prog_version(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_rom(ParserCm* parser, Tokenizer* tokenizer);
+    static bool cmd_skip_value(ParserCm* parser, Tokenizer* tokenizer);
+
+    static bool file_attribute_hash(ParserCm* parser, filetype_t file_type, int hash_type, std::string_view value);
+    static bool file_attribute_merge(ParserCm* parser, filetype_t file_type, int hash_type, std::string_view value);
+    static bool file_attribute_size(ParserCm* parser, filetype_t file_type, int hash_type, std::string_view value);
+    static bool file_attribute_status(ParserCm* parser, filetype_t file_type, int hash_type, std::string_view value);
+
     std::unordered_set<std::string> warned_keywords;
     bool ignoring_line;
-    void warn_unknown_keyword(const std::string& keyword);
+    State parse_state;
+
+    bool expect_open_brace(Tokenizer* tokenizer);
+    bool parse_file(Tokenizer* tokenizer, filetype_t file_type);
+    void warn_unknown_keyword(std::string_view keyword);
 };
 
 #endif // HAD_PARSER_CM_H
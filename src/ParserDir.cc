@@ -35,13 +35,18 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <limits>
 
 #include "Archive.h"
 #include "Dir.h"
 #include "format.h"
 #include "globals.h"
+#include "parallel.h"
 #include "util.h"
 
+// Number of archives queued per parallel job before their hashes are computed.
+static const size_t archives_per_job = 8;
+
 bool ParserDir::parse() {
     lineno = 0;
 
@@ -68,8 +73,7 @@ bool ParserDir::parse() {
                         if (images && !images->is_empty()) {
                             dir_empty = false;
                             std::sort(images->files.begin(), images->files.end());
-                            start_game(images->name, directory_name);
-                            parse_archive(TYPE_DISK, images.get());
+                            add_archive(images, TYPE_DISK, images->name, directory_name, false);
                         }
                     }
                     {
@@ -87,16 +91,15 @@ bool ParserDir::parse() {
                                     continue;
                                 }
                                 else if (is_ziplike(file.name)) {
-                                    auto a = Archive::open(filepath / file.name, TYPE_ROM, FILE_NOWHERE, 0);
+                                    auto a = Archive::open(filepath / file.name, TYPE_ROM, FILE_NOWHERE,
+                                                           ARCHIVE_FL_DEFER_HASHES);
                                     if (a) {
                                         auto name = a->name;
                                         if (!runtest) {
                                             auto extension = std::filesystem::path(name).extension();
                                             name = name.substr(0, name.length() - extension.string().length());
                                         }
-                                        start_game(name, directory_name);
-                                        parse_archive(TYPE_ROM, a.get());
-                                        end_game();
+                                        add_archive(a, TYPE_ROM, name, directory_name);
                                     }
                                 }
                                 else {
@@ -114,16 +117,14 @@ bool ParserDir::parse() {
                     switch (name_type(entry)) {
                     case NAME_ZIP: {
                         /* TODO: handle errors */
-                        auto a = Archive::open(filepath, TYPE_ROM, FILE_NOWHERE, 0);
+                        auto a = Archive::open(filepath, TYPE_ROM, FILE_NOWHERE, ARCHIVE_FL_DEFER_HASHES);
                         if (a) {
                             auto name = a->name;
                             if (!runtest) {
                                 auto extension = std::filesystem::path(name).extension();
                                 name = name.substr(0, name.length() - extension.string().length());
                             }
-                            start_game(name, directory_name);
-                            parse_archive(TYPE_ROM, a.get());
-                            end_game();
+                            add_archive(a, TYPE_ROM, name, directory_name);
                         }
                         break;
                     }
@@ -151,15 +152,15 @@ bool ParserDir::parse() {
                 }
             }
 
+            flush_archives();
             end_game();
 
             if (have_loose_chds) {
                 auto a = Archive::open_toplevel(directory_name, TYPE_DISK, FILE_NOWHERE, 0);
 
                 if (a) {
-                    start_game(".", "");
-                    parse_archive(TYPE_DISK, a.get());
-                    end_game();
+                    add_archive(a, TYPE_DISK, ".", "");
+                    flush_archives();
                 }
             }
         }
@@ -173,11 +174,9 @@ bool ParserDir::parse() {
 
                 if (entry.is_directory()) {
                     /* TODO: handle errors */
-                    auto a = Archive::open(entry.path(), TYPE_ROM, FILE_NOWHERE, 0);
+                    auto a = Archive::open(entry.path(), TYPE_ROM, FILE_NOWHERE, ARCHIVE_FL_DEFER_HASHES);
                     if (a) {
-                        start_game(a->name, directory_name);
-                        parse_archive(TYPE_ROM, a.get());
-                        end_game();
+                        add_archive(a, TYPE_ROM, a->name, directory_name);
                     }
                 }
                 else {
@@ -193,13 +192,14 @@ bool ParserDir::parse() {
                 }
             }
 
+            flush_archives();
+
             if (have_loose_files) {
-                auto a = Archive::open_toplevel(directory_name, TYPE_ROM, FILE_NOWHERE, 0);
+                auto a = Archive::open_toplevel(directory_name, TYPE_ROM, FILE_NOWHERE, ARCHIVE_FL_DEFER_HASHES);
 
                 if (a) {
-                    start_game(".", "");
-                    parse_archive(TYPE_ROM, a.get());
-                    end_game();
+                    add_archive(a, TYPE_ROM, ".", "");
+                    flush_archives();
                 }
             }
         }
@@ -207,6 +207,7 @@ bool ParserDir::parse() {
         eof();
     }
     catch (...) {
+        pending_archives.clear();
         return false;
     }
 
@@ -214,6 +215,60 @@ bool ParserDir::parse() {
 }
 
 
+void ParserDir::add_archive(ArchivePtr archive, filetype_t filetype, std::string game_name,
+                            const std::string& top_directory, bool end_game) {
+    pending_archives.emplace_back(std::move(archive), filetype, std::move(game_name), top_directory, end_game);
+
+    // Without parallel jobs, add each archive right away, so messages are printed in the same order as before.
+    auto jobs = parallel_jobs(std::numeric_limits<size_t>::max());
+    if (pending_archives.size() >= (jobs > 1 ? jobs * archives_per_job : 1)) {
+        flush_archives();
+    }
+}
+
+
+void ParserDir::flush_archives() {
+    try {
+        parallel_for(pending_archives.size(), [this](size_t index) {
+            auto& pending = pending_archives[index];
+
+            output.start_capture();
+            try {
+                if (pending.filetype == TYPE_ROM) {
+                    for (size_t i = 0; i < pending.archive->files.size(); i++) {
+                        pending.archive->file_ensure_hashes(i, hashtypes);
+                    }
+                }
+            }
+            catch (...) {
+                pending.messages = output.end_capture();
+                throw;
+            }
+            pending.messages = output.end_capture();
+        });
+    }
+    catch (...) {
+        for (const auto& pending : pending_archives) {
+            output.print_captured(pending.messages);
+        }
+        pending_archives.clear();
+        throw;
+    }
+
+    // Archives are closed here, on the main thread, which updates their cache database.
+    auto archives = std::move(pending_archives);
+    pending_archives.clear();
+    for (auto& pending : archives) {
+        output.print_captured(pending.messages);
+        start_game(pending.game_name, pending.top_directory);
+        parse_archive(pending.filetype, pending.archive.get());
+        if (pending.end_game) {
+            end_game();
+        }
+    }
+}
+
+
 bool ParserDir::parse_archive(filetype_t filetype, Archive* a) {
     std::string name;
 
@@ -35,13 +35,15 @@
 */
 
 #include <utility>
+#include <vector>
 
 #include "Archive.h"
 #include "Parser.h"
 
 class ParserDir : public Parser {
   public:
-    ParserDir(ParserSourcePtr source, const std::unordered_set<std::string>& exclude, OutputContext* output, const DatOptions& options, std::string dname, int hashtypes_, bool runtest_ = false)
+    ParserDir(ParserSourcePtr source, const std::unordered_set<std::string>& exclude, OutputContext* output,
+              const DatOptions& options, std::string dname, int hashtypes_, bool runtest_ = false)
         : Parser(std::move(source), exclude, output, options),
           directory_name(std::move(dname)),
           hashtypes(hashtypes_),
@@ -51,6 +53,29 @@ class ParserDir : public Parser {
     bool parse() override;
 
   private:
+    class PendingArchive {
+      public:
+        PendingArchive(ArchivePtr archive, filetype_t filetype, std::string game_name, std::string top_directory,
+                       bool end_game)
+            : archive(std::move(archive)),
+              filetype(filetype),
+              game_name(std::move(game_name)),
+              top_directory(std::move(top_directory)),
+              end_game(end_game) {}
+
+        ArchivePtr archive;
+        filetype_t filetype;
+        std::string game_name;
+        std::string top_directory;
+        bool end_game;
+        std::vector<Output::CapturedMessage> messages;
+    };
+
+    // Queue archive to be added as game once its hashes have been computed.
+    void add_archive(ArchivePtr archive, filetype_t filetype, std::string game_name, const std::string& top_directory,
+                     bool end_game = true);
+    // Compute hashes of queued archives in parallel, then add them in order.
+    void flush_archives();
     bool parse_archive(filetype_t filetype, Archive* a);
     void end_game();
     void start_game(const std::string& name, const std::string& top_directory);
@@ -60,6 +85,7 @@ class ParserDir : public Parser {
     bool runtest;
 
     std::string current_game;
+    std::vector<PendingArchive> pending_archives;
 };
 
 #endif // HAD_PARSER_DIR_H
@@ -37,11 +37,9 @@
 
 const char ParserRc::separator = static_cast<char>(0xac);
 
-std::unordered_map<std::string, ParserRc::Section> ParserRc::sections = {{"[CREDITS]", RC_CREDITS},
-                                                                         {"[DAT]", RC_DAT},
-                                                                         {"[EMULATOR]", RC_EMULATOR},
-                                                                         {"[GAMES]", RC_GAMES},
-                                                                         {"[RESOURCES]", RC_GAMES}};
+const std::unordered_map<std::string_view, ParserRc::Section> ParserRc::sections = {
+    {"[CREDITS]", RC_CREDITS}, {"[DAT]", RC_DAT}, {"[EMULATOR]", RC_EMULATOR}, {"[GAMES]", RC_GAMES},
+    {"[RESOURCES]", RC_GAMES}};
 
 std::vector<ParserRc::Field> ParserRc::fields = {
     Field(RC_CREDITS, "version", parse_prog_version), Field(RC_DAT, "plugin", rc_plugin),
@@ -53,12 +51,12 @@ bool ParserRc::parse() {
     lineno = 0;
     auto sect = RC_UNKNOWN;
 
-    std::optional<std::string> l;
+    std::optional<std::span<char>> l;
     while (!end_parsing && (l = ps->getline()).has_value()) {
         lineno++;
-        auto line = l.value();
+        auto line = std::string_view(l->data(), l->size());
 
-        if (line[0] == '[') {
+        if (line.starts_with('[')) {
             auto it = sections.find(line);
             if (it != sections.end()) {
                 sect = it->second;
@@ -77,7 +75,7 @@ bool ParserRc::parse() {
         }
         else {
             auto position = line.find('=');
-            if (position == std::string::npos) {
+            if (position == std::string_view::npos) {
                 output.line_error(lineno, "no `=' found");
                 ok = false;
                 continue;
@@ -97,18 +95,18 @@ bool ParserRc::parse() {
     return ok;
 }
 
-std::string ParserRc::Tokenizer::get() {
-    if (position == std::string::npos) {
-        return "";
+std::string_view ParserRc::Tokenizer::get() {
+    if (position == std::string_view::npos) {
+        return {};
     }
 
     auto sep = string.find(separator, position);
 
-    std::string field;
+    std::string_view field;
 
-    if (sep == std::string::npos) {
+    if (sep == std::string_view::npos) {
         field = string.substr(position);
-        position = std::string::npos;
+        position = std::string_view::npos;
     }
     else {
         field = string.substr(position, sep - position);
@@ -119,13 +117,13 @@ std::string ParserRc::Tokenizer::get() {
 }
 
 
-bool ParserRc::parse_prog_description(ParserRc* ctx, const std::string& attr) { return ctx->prog_description(attr); }
+bool ParserRc::parse_prog_description(ParserRc* ctx, std::string_view attr) { return ctx->prog_description(attr); }
 
-bool ParserRc::parse_prog_name(ParserRc* ctx, const std::string& attr) { return ctx->prog_name(attr); }
+bool ParserRc::parse_prog_name(ParserRc* ctx, std::string_view attr) { return ctx->prog_name(attr); }
 
-bool ParserRc::parse_prog_version(ParserRc* ctx, const std::string& attr) { return ctx->prog_version(attr); }
+bool ParserRc::parse_prog_version(ParserRc* ctx, std::string_view attr) { return ctx->prog_version(attr); }
 
-bool ParserRc::rc_plugin(ParserRc* ctx, const std::string& attr) {
+bool ParserRc::rc_plugin(ParserRc* ctx, std::string_view attr) {
     output.line_error(ctx->lineno, "warning: RomCenter plugins not supported,");
     output.line_error(ctx->lineno, "warning: DAT won't work as expected.");
     return false;
@@ -139,7 +137,7 @@ void ParserRc::flush_romline() {
     gamename = "";
 }
 
-bool ParserRc::process_romline(const std::string& line) {
+bool ParserRc::process_romline(std::string_view line) {
     auto tokenizer = Tokenizer(line);
 
     if (!tokenizer.get().empty()) {
@@ -34,6 +34,7 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <string_view>
 #include <utility>
 
 #include "Parser.h"
@@ -54,34 +55,34 @@ class ParserRc : public Parser {
 
     class Field {
       public:
-        Field(Section section_, const std::string& name_, bool (*cb_)(ParserRc*, const std::string&))
+        Field(Section section_, const std::string& name_, bool (*cb_)(ParserRc*, std::string_view))
             : section(section_), name(name_), cb(cb_) {}
 
         Section section;
         std::string name;
-        bool (*cb)(ParserRc*, const std::string&);
+        bool (*cb)(ParserRc*, std::string_view);
     };
 
-    static std::unordered_map<std::string, Section> sections;
+    static const std::unordered_map<std::string_view, Section> sections;
     static std::vector<Field> fields;
 
-    static bool parse_prog_description(ParserRc* ctx, const std::string& attr);
-    static bool parse_prog_name(ParserRc* ctx, const std::string& attr);
-    static bool parse_prog_version(ParserRc* ctx, const std::string& attr);
-    static bool rc_plugin(ParserRc* ctx, const std::string& attr);
+    static bool parse_prog_description(ParserRc* ctx, std::string_view attr);
+    static bool parse_prog_name(ParserRc* ctx, std::string_view attr);
+    static bool parse_prog_version(ParserRc* ctx, std::string_view attr);
+    static bool rc_plugin(ParserRc* ctx, std::string_view attr);
 
     class Tokenizer {
       public:
-        explicit Tokenizer(const std::string& s) : string(s), position(0) {}
+        explicit Tokenizer(std::string_view s) : string(s), position(0) {}
 
-        std::string get();
+        std::string_view get();
 
       private:
-        std::string string;
+        std::string_view string;
         size_t position;
     };
 
-    bool process_romline(const std::string& line);
+    bool process_romline(std::string_view line);
     void flush_romline();
 
     std::string gamename;
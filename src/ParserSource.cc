@@ -36,41 +36,44 @@
 #include <cstring>
 
 
-#define PSBLKSIZE 1024
+#define PSBLKSIZE (64 * 1024)
 
 ParserSource::ParserSource() : current(nullptr), available(0) {}
 
 ParserSource::~ParserSource() { close(); }
 
 
-std::optional<std::string> ParserSource::getline() {
+std::optional<std::span<char>> ParserSource::getline() {
+    size_t scanned = 0;
+
     for (;;) {
         char* p;
-        if (available > 0 && (p = reinterpret_cast<char*>(memchr(current, '\n', available))) != nullptr) {
+        if (available > scanned &&
+            (p = reinterpret_cast<char*>(memchr(current + scanned, '\n', available - scanned))) != nullptr) {
             auto line = reinterpret_cast<char*>(current);
             auto line_length = static_cast<size_t>(p - line);
+            buffer_consume(line_length + 1);
             if (line_length > 0 && line[line_length - 1] == '\r') {
-                line[line_length - 1] = '\0';
+                line_length -= 1;
             }
-            else {
-                line[line_length] = '\0';
-            }
-            buffer_consume(line_length + 1);
-            return line;
+            line[line_length] = '\0';
+            return std::span<char>(line, line_length);
         }
+        scanned = available;
 
-        auto old_remaining = available;
-        buffer_fill((available / PSBLKSIZE + 1) * PSBLKSIZE);
+        auto old_available = available;
+        buffer_fill(available + PSBLKSIZE);
 
-        if (old_remaining == available) {
+        if (old_available == available) {
             if (available == 0) {
                 return {};
             }
 
             auto line = reinterpret_cast<char*>(current);
-            line[available] = '\0';
+            auto line_length = available;
             buffer_consume(available);
-            return line;
+            line[line_length] = '\0';
+            return std::span<char>(line, line_length);
         }
     }
 }
@@ -36,6 +36,7 @@
 
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -55,8 +56,12 @@ class ParserSource {
     virtual ParserSourcePtr open(const std::string& name) = 0;
     virtual time_t get_mtime() = 0;
     virtual uint32_t get_crc() = 0;
+    // Open a new source reading the same data from the start, nullptr if not possible.
+    virtual ParserSourcePtr reopen() { return {}; }
 
-    std::optional<std::string> getline();
+    // Get next line, without line terminator. The line points into the internal buffer and stays valid until the next
+    // call that reads from this source. It may be modified in place.
+    std::optional<std::span<char>> getline();
     int peek();
     std::string peek(size_t n);
     size_t read(void* data, size_t length);
@@ -0,0 +1,367 @@
+/*
+  ParserSourceCompressed.cc -- read compressed data from parser source
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "ParserSourceCompressed.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "config.h"
+
+#include <zlib.h>
+#ifdef HAVE_LIBLZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+#include "Exception.h"
+#include "Hashes.h"
+
+#define INPUT_BUFFER_SIZE (64 * 1024)
+
+class ParserSourceCompressed::Decompressor {
+  public:
+    virtual ~Decompressor() = default;
+
+    // Decompress up to `length` bytes read from `source` into `data`, returns 0 at end of data.
+    size_t read(ParserSource* source, void* data, size_t length);
+
+  protected:
+    std::vector<uint8_t> input = std::vector<uint8_t>(INPUT_BUFFER_SIZE);
+    const uint8_t* next_in = nullptr;
+    size_t available_in = 0;
+    bool input_eof = false;
+    bool done = false;
+
+    // Decompress from `next_in` into `data`, updates `next_in` and `available_in`, returns number of bytes produced.
+    virtual size_t decompress(uint8_t* data, size_t length) = 0;
+};
+
+namespace {
+class DecompressorGzip : public ParserSourceCompressed::Decompressor {
+  public:
+    DecompressorGzip();
+    ~DecompressorGzip() override;
+
+  protected:
+    size_t decompress(uint8_t* data, size_t length) override;
+
+  private:
+    z_stream stream{};
+    bool member_end = false;
+};
+
+#ifdef HAVE_LIBLZMA
+class DecompressorXz : public ParserSourceCompressed::Decompressor {
+  public:
+    DecompressorXz();
+    ~DecompressorXz() override;
+
+  protected:
+    size_t decompress(uint8_t* data, size_t length) override;
+
+  private:
+    lzma_stream stream = LZMA_STREAM_INIT;
+};
+#endif
+
+#ifdef HAVE_LIBZSTD
+class DecompressorZstd : public ParserSourceCompressed::Decompressor {
+  public:
+    DecompressorZstd();
+    ~DecompressorZstd() override;
+
+  protected:
+    size_t decompress(uint8_t* data, size_t length) override;
+
+  private:
+    ZSTD_DStream* stream;
+    bool frame_end = true;
+};
+#endif
+} // namespace
+
+
+std::optional<ParserSourceCompressed::Format> ParserSourceCompressed::detect(ParserSource* source) {
+    static const std::string gzip_magic = "\x1f\x8b";
+    static const std::string xz_magic = std::string("\xfd" "7zXZ\0", 6);
+    static const std::string zstd_magic = "\x28\xb5\x2f\xfd";
+
+    auto start = source->peek(xz_magic.length());
+
+    if (start.starts_with(gzip_magic)) {
+        return GZIP;
+    }
+    if (start.starts_with(xz_magic)) {
+        return XZ;
+    }
+    if (start.starts_with(zstd_magic)) {
+        return ZSTD;
+    }
+    return {};
+}
+
+
+ParserSourceCompressed::ParserSourceCompressed(ParserSourcePtr source_, Format format_)
+    : source(std::move(source_)), format(format_) {
+    switch (format) {
+    case GZIP:
+        decompressor = std::make_unique<DecompressorGzip>();
+        break;
+
+    case XZ:
+#ifdef HAVE_LIBLZMA
+        decompressor = std::make_unique<DecompressorXz>();
+        break;
+#else
+        throw Exception("xz compressed files not supported");
+#endif
+
+    case ZSTD:
+#ifdef HAVE_LIBZSTD
+        decompressor = std::make_unique<DecompressorZstd>();
+        break;
+#else
+        throw Exception("zstd compressed files not supported");
+#endif
+    }
+
+    error_file_info = source->error_file_info;
+}
+
+
+ParserSourceCompressed::~ParserSourceCompressed() = default;
+
+
+size_t ParserSourceCompressed::read_xxx(void* data, size_t length) {
+    return decompressor->read(source.get(), data, length);
+}
+
+
+uint32_t ParserSourceCompressed::get_crc() {
+    auto fresh_source = reopen();
+
+    if (!fresh_source) {
+        return 0;
+    }
+
+    Hashes h;
+    h.add_types(Hashes::TYPE_CRC);
+    Hashes::Update hu(&h);
+
+    try {
+        size_t n;
+        char buffer[8192];
+        while ((n = fresh_source->read(buffer, sizeof(buffer))) > 0) {
+            hu.update(buffer, n);
+        }
+    }
+    catch (const Exception&) {
+        return 0;
+    }
+    hu.end();
+    return h.crc;
+}
+
+
+ParserSourcePtr ParserSourceCompressed::reopen() {
+    auto fresh_source = source->reopen();
+
+    if (!fresh_source) {
+        return {};
+    }
+
+    return static_cast<ParserSourcePtr>(std::make_shared<ParserSourceCompressed>(fresh_source, format));
+}
+
+
+size_t ParserSourceCompressed::Decompressor::read(ParserSource* source, void* data, size_t length) {
+    auto out = static_cast<uint8_t*>(data);
+    size_t done_length = 0;
+
+    while (!done && done_length < length) {
+        if (available_in == 0 && !input_eof) {
+            available_in = source->read(input.data(), input.size());
+            next_in = input.data();
+            if (available_in == 0) {
+                input_eof = true;
+            }
+        }
+
+        done_length += decompress(out + done_length, length - done_length);
+    }
+
+    return done_length;
+}
+
+
+DecompressorGzip::DecompressorGzip() {
+    // 16: decode gzip header and trailer
+    if (inflateInit2(&stream, MAX_WBITS + 16) != Z_OK) {
+        throw Exception("cannot initialize gzip decompression: {}", stream.msg ? stream.msg : "unknown error");
+    }
+}
+
+
+DecompressorGzip::~DecompressorGzip() { inflateEnd(&stream); }
+
+
+size_t DecompressorGzip::decompress(uint8_t* data, size_t length) {
+    if (member_end) {
+        if (available_in == 0) {
+            if (input_eof) {
+                done = true;
+            }
+            return 0;
+        }
+        // another gzip member follows, as produced by concatenating files
+        inflateReset(&stream);
+        member_end = false;
+    }
+
+    stream.next_in = const_cast<Bytef*>(next_in);
+    stream.avail_in = static_cast<uInt>(available_in);
+    stream.next_out = data;
+    stream.avail_out = static_cast<uInt>(std::min(length, static_cast<size_t>(UINT_MAX)));
+
+    auto ret = inflate(&stream, Z_NO_FLUSH);
+
+    auto produced = static_cast<size_t>(stream.next_out - data);
+    next_in = stream.next_in;
+    available_in = stream.avail_in;
+
+    switch (ret) {
+    case Z_STREAM_END:
+        member_end = true;
+        break;
+
+    case Z_OK:
+        break;
+
+    case Z_BUF_ERROR:
+        if (input_eof && available_in == 0) {
+            throw Exception("unexpected end of gzip compressed data");
+        }
+        break;
+
+    default:
+        throw Exception("error decompressing gzip data: {}", stream.msg ? stream.msg : "unknown error");
+    }
+
+    return produced;
+}
+
+
+#ifdef HAVE_LIBLZMA
+DecompressorXz::DecompressorXz() {
+    if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+        throw Exception("cannot initialize xz decompression");
+    }
+}
+
+
+DecompressorXz::~DecompressorXz() { lzma_end(&stream); }
+
+
+size_t DecompressorXz::decompress(uint8_t* data, size_t length) {
+    stream.next_in = next_in;
+    stream.avail_in = available_in;
+    stream.next_out = data;
+    stream.avail_out = length;
+
+    auto ret = lzma_code(&stream, input_eof ? LZMA_FINISH : LZMA_RUN);
+
+    auto produced = static_cast<size_t>(stream.next_out - data);
+    next_in = stream.next_in;
+    available_in = stream.avail_in;
+
+    switch (ret) {
+    case LZMA_STREAM_END:
+        done = true;
+        break;
+
+    case LZMA_OK:
+        break;
+
+    case LZMA_BUF_ERROR:
+        throw Exception("unexpected end of xz compressed data");
+
+    default:
+        throw Exception("error decompressing xz data");
+    }
+
+    return produced;
+}
+#endif
+
+
+#ifdef HAVE_LIBZSTD
+DecompressorZstd::DecompressorZstd() : stream(ZSTD_createDStream()) {
+    if (stream == nullptr) {
+        throw Exception("cannot initialize zstd decompression");
+    }
+}
+
+
+DecompressorZstd::~DecompressorZstd() { ZSTD_freeDStream(stream); }
+
+
+size_t DecompressorZstd::decompress(uint8_t* data, size_t length) {
+    // Frames follow each other directly, as produced by concatenating files.
+    ZSTD_inBuffer in = {next_in, available_in, 0};
+    ZSTD_outBuffer out = {data, length, 0};
+
+    auto ret = ZSTD_decompressStream(stream, &out, &in);
+
+    if (ZSTD_isError(ret)) {
+        throw Exception("error decompressing zstd data: {}", ZSTD_getErrorName(ret));
+    }
+
+    next_in += in.pos;
+    available_in -= in.pos;
+
+    if (in.pos > 0 || out.pos > 0) {
+        frame_end = (ret == 0);
+    }
+    else if (input_eof) {
+        if (!frame_end) {
+            throw Exception("unexpected end of zstd compressed data");
+        }
+        done = true;
+    }
+
+    return out.pos;
+}
+#endif
@@ -87,6 +87,15 @@ ParserSourcePtr ParserSourceFile::open(const std::string& name) {
 }
 
 
+ParserSourcePtr ParserSourceFile::reopen() {
+    if (is_stdin()) {
+        return {};
+    }
+
+    return static_cast<ParserSourcePtr>(std::make_shared<ParserSourceFile>(file_name));
+}
+
+
 size_t ParserSourceFile::read_xxx(void* data, size_t length) {
     if (!is_open()) {
         return 0;
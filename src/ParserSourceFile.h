@@ -50,6 +50,7 @@ class ParserSourceFile : public ParserSource {
     size_t read_xxx(void* data, size_t length) override;
     time_t get_mtime() override;
     uint32_t get_crc() override;
+    ParserSourcePtr reopen() override;
 
   private:
     std::string file_name;
@@ -40,8 +40,8 @@
 #include "globals.h"
 
 ParserSourceZip::ParserSourceZip(const std::string& archive_name_, struct zip* za_, const std::string& fname,
-                                 bool relaxed)
-    : archive_name(archive_name_), za(za_), zf(nullptr) {
+                                 bool relaxed_)
+    : archive_name(archive_name_), file_name(fname), relaxed(relaxed_), za(za_), zf(nullptr) {
     zip_flags_t flags = relaxed ? ZIP_FL_NOCASE | ZIP_FL_NODIR : 0;
 
     zip_stat_t st;
@@ -101,6 +101,11 @@ ParserSourcePtr ParserSourceZip::open(const std::string& name) {
 }
 
 
+ParserSourcePtr ParserSourceZip::reopen() {
+    return static_cast<ParserSourcePtr>(std::make_shared<ParserSourceZip>(archive_name, za, file_name, relaxed));
+}
+
+
 size_t ParserSourceZip::read_xxx(void* data, size_t length) {
     if (zf == nullptr) {
         return 0;
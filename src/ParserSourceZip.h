@@ -49,9 +49,12 @@ class ParserSourceZip : public ParserSource {
     size_t read_xxx(void* data, size_t length) override;
     time_t get_mtime() override { return mtime; }
     uint32_t get_crc() override { return crc; }
+    ParserSourcePtr reopen() override;
 
   private:
     std::string archive_name;
+    std::string file_name;
+    bool relaxed;
     struct zip* za;
     struct zip_file* zf;
     time_t mtime;
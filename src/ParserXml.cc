@@ -58,7 +58,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_end(void* ctx, const void* ar
 }
 
 
-XmlProcessor::CallbackStatus ParserXml::parse_file_hash(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_file_hash(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -66,7 +66,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_hash(void* ctx, const void* a
 }
 
 
-XmlProcessor::CallbackStatus ParserXml::parse_file_loadflag(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_file_loadflag(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -80,7 +80,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_loadflag(void* ctx, const voi
 }
 
 
-XmlProcessor::CallbackStatus ParserXml::parse_file_merge(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_file_merge(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -88,7 +88,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_merge(void* ctx, const void*
 }
 
 
-XmlProcessor::CallbackStatus ParserXml::parse_file_mia(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_file_mia(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -96,7 +96,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_mia(void* ctx, const void* ar
     return parser->status(parser->file_missing(arguments->file_type, value == "yes"));
 }
 
-XmlProcessor::CallbackStatus ParserXml::parse_file_name(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_file_name(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -112,7 +112,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_start(void* ctx, const void*
 }
 
 
-XmlProcessor::CallbackStatus ParserXml::parse_file_status(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_file_status(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -120,7 +120,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_status(void* ctx, const void*
 }
 
 
-XmlProcessor::CallbackStatus ParserXml::parse_file_size(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_file_size(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -134,7 +134,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_file_size(void* ctx, const void* a
 
 
 XmlProcessor::CallbackStatus ParserXml::parse_game_cloneof(void* ctx, [[maybe_unused]] const void* args,
-                                                           const std::string& value) {
+                                                           std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     return parser->status(parser->game_cloneof(value));
@@ -142,7 +142,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_game_cloneof(void* ctx, [[maybe_un
 
 
 XmlProcessor::CallbackStatus ParserXml::parse_game_description(void* ctx, [[maybe_unused]] const void* args,
-                                                               const std::string& value) {
+                                                               std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     return parser->status(parser->game_description(value));
@@ -157,7 +157,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_game_end(void* ctx, [[maybe_unused
 
 
 XmlProcessor::CallbackStatus ParserXml::parse_game_name(void* ctx, [[maybe_unused]] const void* arguments,
-                                                        const std::string& value) {
+                                                        std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     return parser->status(parser->game_name(value));
@@ -178,7 +178,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_header_end(void* ctx, [[maybe_unus
 }
 
 
-XmlProcessor::CallbackStatus ParserXml::parse_mame_build(void* ctx, const void* args, const std::string& value) {
+XmlProcessor::CallbackStatus ParserXml::parse_mame_build(void* ctx, const void* args, std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
     auto arguments = static_cast<const Arguments*>(args);
 
@@ -191,28 +191,28 @@ XmlProcessor::CallbackStatus ParserXml::parse_mame_build(void* ctx, const void*
 
 
 XmlProcessor::CallbackStatus ParserXml::parse_prog_description(void* ctx, [[maybe_unused]] const void* args,
-                                                               const std::string& value) {
+                                                               std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     return parser->status(parser->prog_description(value));
 }
 
 XmlProcessor::CallbackStatus ParserXml::parse_prog_header(void* ctx, [[maybe_unused]] const void* args,
-                                                          const std::string& value) {
+                                                          std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     return parser->status(parser->prog_header(value));
 }
 
 XmlProcessor::CallbackStatus ParserXml::parse_prog_name(void* ctx, [[maybe_unused]] const void* args,
-                                                        const std::string& value) {
+                                                        std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     return parser->status(parser->prog_name(value));
 }
 
 XmlProcessor::CallbackStatus ParserXml::parse_prog_version(void* ctx, [[maybe_unused]] const void* args,
-                                                           const std::string& value) {
+                                                           std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     return parser->status(parser->prog_version(value));
@@ -220,7 +220,7 @@ XmlProcessor::CallbackStatus ParserXml::parse_prog_version(void* ctx, [[maybe_un
 
 
 XmlProcessor::CallbackStatus ParserXml::parse_softwarelist_name(void* ctx, [[maybe_unused]] const void* args,
-                                                                const std::string& value) {
+                                                                std::string_view value) {
     auto parser = static_cast<ParserXml*>(ctx);
 
     auto ok = parser->prog_name(value);
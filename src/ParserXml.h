@@ -80,35 +80,35 @@ class ParserXml : public Parser {
     static const std::unordered_map<std::string, XmlProcessor::Attribute> attributes_softwarelist;
 
     static XmlProcessor::CallbackStatus parse_file_end(void* ctx, const void* args);
-    static XmlProcessor::CallbackStatus parse_file_hash(void* ctx, const void* args, const std::string& value);
-    static XmlProcessor::CallbackStatus parse_file_loadflag(void* ctx, const void* args, const std::string& value);
-    static XmlProcessor::CallbackStatus parse_file_merge(void* ctx, const void* args, const std::string& value);
-    static XmlProcessor::CallbackStatus parse_file_mia(void* ctx, const void* args, const std::string& value);
-    static XmlProcessor::CallbackStatus parse_file_name(void* ctx, const void* args, const std::string& value);
+    static XmlProcessor::CallbackStatus parse_file_hash(void* ctx, const void* args, std::string_view value);
+    static XmlProcessor::CallbackStatus parse_file_loadflag(void* ctx, const void* args, std::string_view value);
+    static XmlProcessor::CallbackStatus parse_file_merge(void* ctx, const void* args, std::string_view value);
+    static XmlProcessor::CallbackStatus parse_file_mia(void* ctx, const void* args, std::string_view value);
+    static XmlProcessor::CallbackStatus parse_file_name(void* ctx, const void* args, std::string_view value);
     static XmlProcessor::CallbackStatus parse_file_start(void* ctx, const void* args);
-    static XmlProcessor::CallbackStatus parse_file_status(void* ctx, const void* args, const std::string& value);
-    static XmlProcessor::CallbackStatus parse_file_size(void* ctx, const void* args, const std::string& value);
+    static XmlProcessor::CallbackStatus parse_file_status(void* ctx, const void* args, std::string_view value);
+    static XmlProcessor::CallbackStatus parse_file_size(void* ctx, const void* args, std::string_view value);
     static XmlProcessor::CallbackStatus parse_game_cloneof(void* ctx, [[maybe_unused]] const void* args,
-                                                           const std::string& value);
+                                                           std::string_view value);
     static XmlProcessor::CallbackStatus parse_game_description(void* ctx, [[maybe_unused]] const void* args,
-                                                               const std::string& value);
+                                                               std::string_view value);
     static XmlProcessor::CallbackStatus parse_game_end(void* ctx, [[maybe_unused]] const void* args);
     static XmlProcessor::CallbackStatus parse_game_name(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args,
-                                                        const std::string& value);
+                                                        std::string_view value);
     static XmlProcessor::CallbackStatus parse_game_start(void* ctx, [[maybe_unused]] const void* args);
     static XmlProcessor::CallbackStatus parse_header_end(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args);
     static XmlProcessor::CallbackStatus parse_mame_build(void* context, const void* arguments,
-                                                         const std::string& value);
+                                                         std::string_view value);
     static XmlProcessor::CallbackStatus
-    parse_prog_description(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args, const std::string& value);
+    parse_prog_description(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args, std::string_view value);
     static XmlProcessor::CallbackStatus parse_prog_header(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args,
-                                                          const std::string& value);
+                                                          std::string_view value);
     static XmlProcessor::CallbackStatus parse_prog_name(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args,
-                                                        const std::string& value);
+                                                        std::string_view value);
     static XmlProcessor::CallbackStatus
-    parse_prog_version(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args, const std::string& value);
+    parse_prog_version(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args, std::string_view value);
     static XmlProcessor::CallbackStatus
-    parse_softwarelist_name(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args, const std::string& value);
+    parse_softwarelist_name(void* ctx, [[maybe_unused]] [[maybe_unused]] const void* args, std::string_view value);
 
     XmlProcessor::CallbackStatus status(bool ok);
 };
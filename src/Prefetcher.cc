@@ -0,0 +1,176 @@
+/*
+  Prefetcher.cc -- read archive metadata ahead in background thread
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "Prefetcher.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+// End of central directory record: signature, 16 bytes of fields, comment length, comment of up to 64KiB.
+static constexpr size_t EOCD_SIZE = 22;
+static constexpr size_t EOCD_MAX_COMMENT_SIZE = 0xffff;
+static constexpr uint8_t EOCD_MAGIC[] = {'P', 'K', 5, 6};
+
+// Size of reads of the central directory; the data is discarded, it only has to pass through the cache.
+static constexpr size_t READ_SIZE = 64 * 1024;
+
+
+Prefetcher::Prefetcher() : thread([this]() { run(); }) {}
+
+
+Prefetcher::~Prefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    condition.notify_one();
+    thread.join();
+}
+
+
+void Prefetcher::add(const std::string& name, size_t position) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(Entry{name, position});
+    }
+    condition.notify_one();
+}
+
+
+void Prefetcher::advance(size_t position) {
+    std::lock_guard<std::mutex> lock(mutex);
+    current_position = position;
+    while (!queue.empty() && queue.front().position < current_position) {
+        queue.pop_front();
+    }
+}
+
+
+void Prefetcher::run() {
+    while (true) {
+        std::string name;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return done || !queue.empty(); });
+            if (done) {
+                return;
+            }
+            name = std::move(queue.front().name);
+            queue.pop_front();
+        }
+
+        prefetch(name);
+    }
+}
+
+
+void Prefetcher::prefetch(const std::string& name) {
+    std::error_code ec;
+    auto status = std::filesystem::status(name, ec);
+
+    if (ec) {
+        return;
+    }
+
+    if (std::filesystem::is_directory(status)) {
+        try {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(name, ec)) {
+                (void)entry.is_regular_file(ec);
+                (void)entry.file_size(ec);
+            }
+        }
+        catch (...) {
+            // Errors are reported when the directory is opened for checking.
+        }
+    }
+    else if (std::filesystem::is_regular_file(status)) {
+        prefetch_zip(name);
+    }
+}
+
+
+void Prefetcher::prefetch_zip(const std::string& name) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(name, ec);
+    if (ec || size < EOCD_SIZE) {
+        return;
+    }
+
+    auto file = std::ifstream(name, std::ios::in | std::ios::binary);
+    if (!file) {
+        return;
+    }
+
+    auto tail_size = std::min(size, static_cast<uint64_t>(EOCD_SIZE + EOCD_MAX_COMMENT_SIZE));
+    auto tail_offset = size - tail_size;
+    std::vector<uint8_t> tail(tail_size);
+    file.seekg(static_cast<std::streamoff>(tail_offset));
+    if (!file.read(reinterpret_cast<char*>(tail.data()), static_cast<std::streamsize>(tail_size))) {
+        return;
+    }
+
+    auto it = std::find_end(tail.begin(), tail.end() - (EOCD_SIZE - sizeof(EOCD_MAGIC)), std::begin(EOCD_MAGIC),
+                            std::end(EOCD_MAGIC));
+    if (it == tail.end() - (EOCD_SIZE - sizeof(EOCD_MAGIC))) {
+        return;
+    }
+
+    auto eocd = &*it;
+    auto cd_size = static_cast<uint64_t>(eocd[12]) | static_cast<uint64_t>(eocd[13]) << 8 |
+                   static_cast<uint64_t>(eocd[14]) << 16 | static_cast<uint64_t>(eocd[15]) << 24;
+    auto cd_offset = static_cast<uint64_t>(eocd[16]) | static_cast<uint64_t>(eocd[17]) << 8 |
+                     static_cast<uint64_t>(eocd[18]) << 16 | static_cast<uint64_t>(eocd[19]) << 24;
+
+    // Zip64 archives and inconsistent values are left to libzip.
+    if (cd_offset + cd_size > size) {
+        return;
+    }
+    if (cd_offset >= tail_offset) {
+        // Central directory was read with the tail.
+        return;
+    }
+
+    // The part of the central directory not already read with the tail.
+    std::vector<char> buffer(READ_SIZE);
+    file.seekg(static_cast<std::streamoff>(cd_offset));
+    auto remaining = tail_offset - cd_offset;
+    while (remaining > 0) {
+        auto n = std::min(remaining, static_cast<uint64_t>(buffer.size()));
+        if (!file.read(buffer.data(), static_cast<std::streamsize>(n))) {
+            return;
+        }
+        remaining -= n;
+    }
+}
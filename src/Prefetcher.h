@@ -0,0 +1,81 @@
+#ifndef HAD_PREFETCHER_H
+#define HAD_PREFETCHER_H
+
+/*
+  Prefetcher.h -- read archive metadata ahead in background thread
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Read metadata of files in a background thread so it is in the operating system's cache when they are opened.
+ *
+ * For directories, all entries are looked up. For files, the central directory of zip archives is read.
+ */
+class Prefetcher {
+  public:
+    Prefetcher();
+    ~Prefetcher();
+
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    /// Queue file to read, to be used at `position`.
+    void add(const std::string& name, size_t position);
+
+    /// Note that everything before `position` has been used; files queued for earlier positions are dropped.
+    void advance(size_t position);
+
+  private:
+    class Entry {
+      public:
+        std::string name;
+        size_t position;
+    };
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Entry> queue;
+    size_t current_position{0};
+    bool done{false};
+    std::thread thread;
+
+    void run();
+    static void prefetch(const std::string& name);
+    static void prefetch_zip(const std::string& name);
+};
+
+#endif // HAD_PREFETCHER_H
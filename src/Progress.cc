@@ -40,7 +40,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProgramName.h"
 #include "globals.h"
 
-std::vector<std::string> Progress::messages;
+thread_local std::vector<std::string> Progress::messages;
 volatile bool Progress::siginfo_caught = false;
 bool Progress::trace = false;
 
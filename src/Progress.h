@@ -67,7 +67,7 @@ class Progress {
 
     static volatile bool siginfo_caught;
 
-    static std::vector<std::string> messages;
+    static thread_local std::vector<std::string> messages;
 };
 
 #endif // PROGRESS_H
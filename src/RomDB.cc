@@ -40,7 +40,7 @@ std::unique_ptr<RomDB> db;
 std::unique_ptr<RomDB> old_db;
 
 const DB::DBFormat RomDB::format = {0x0,
-                                    5,
+                                    7,
                                     "\
 create table dat (\n\
     dat_idx integer primary key,\n\
@@ -48,7 +48,8 @@ create table dat (\n\
     description text,\n\
     author text,\n\
     version text,\n\
-    crc int\n\
+    crc int,\n\
+    options int\n\
 );\n\
 \n\
 create table game (\n\
@@ -102,24 +103,39 @@ alter table file add column missing integer not null default 0;\n\
 "},
                                      {MigrationVersions(4, 5), "\
 alter table dat add column crc int;\n\
-"}}
-
-};
+"},
+                                     {MigrationVersions(5, 6), "\
+drop index if exists file_crc;\n\
+drop index if exists file_md5;\n\
+drop index if exists file_sha1;\n\
+create index file_crc on file (crc, file_type, status);\n\
+create index file_md5 on file (md5, file_type, status);\n\
+create index file_sha1 on file (sha1, file_type, status);\n\
+create index file_sha256 on file (sha256, file_type, status);\n\
+"},
+                                     {MigrationVersions(6, 7), "\
+alter table dat add column options int;\n\
+"}},
+                                    // read heavily while checking
+                                    {true, 32 * 1024, 256 * 1024 * 1024}};
 
+// The hash indices also cover the file type and status, so QUERY_FILE_FBH only reads matching rows from the table.
 const std::string RomDB::init2_sql = "\
 create index file_name on file (name);\n\
 create index file_size on file (size);\n\
-create index file_crc on file (crc);\n\
-create index file_md5 on file (md5);\n\
-create index file_sha1 on file (sha1);\n";
+create index file_crc on file (crc, file_type, status);\n\
+create index file_md5 on file (md5, file_type, status);\n\
+create index file_sha1 on file (sha1, file_type, status);\n\
+create index file_sha256 on file (sha256, file_type, status);\n";
 
 
 std::unordered_map<int, std::string> RomDB::queries = {
+    {DELETE_DAT, "delete from dat where dat_idx = :dat_idx"},
     {DELETE_FILE, "delete from file where game_id = :game_id"},
     {DELETE_GAME, "delete from game where game_id = :game_id"},
     {INSERT_DAT_DETECTOR, "insert into dat (dat_idx, name, author, version) values (-1, :name, :author, :version)"},
-    {INSERT_DAT, "insert into dat (dat_idx, name, description, version, crc) values (:dat_idx, :name, :description, "
-                 ":version, :crc)"},
+    {INSERT_DAT, "insert into dat (dat_idx, name, description, version, crc, options) values (:dat_idx, :name, "
+                 ":description, :version, :crc, :options)"},
     {INSERT_FILE, "insert into file (game_id, file_type, file_idx, name, merge, status, location, size, crc, md5, "
                   "sha1, sha256, missing) values (:game_id, :file_type, :file_idx, :name, :merge, :status, :location, "
                   ":size, :crc, :md5, :sha1, :sha256, :missing)"},
@@ -131,11 +147,14 @@ std::unordered_map<int, std::string> RomDB::queries = {
                   ":test_idx, :type, :offset, :size, :mask, :value, :result)"},
     {QUERY_CLONES, "select name from game where parent = :parent"},
     {QUERY_DAT_DETECTOR, "select name, author, version from dat where dat_idx = -1"},
-    {QUERY_DAT, "select name, description, version, crc from dat where dat_idx >= 0 order by dat_idx"},
+    {QUERY_DAT, "select name, description, version, crc, options from dat where dat_idx >= 0 order by dat_idx"},
+    {QUERY_FILE_ALL, "select game_id, file_type, name, merge, status, location, size, crc, md5, sha1, sha256, missing "
+                     "from file order by game_id, file_type, file_idx"},
     {QUERY_FILE_FBN, "select g.name, f.file_idx from game g, file f where f.game_id = g.game_id and f.file_type = "
                      ":file_type and f.name = :name"},
     {QUERY_FILE, "select name, merge, status, location, size, crc, md5, sha1, sha256, missing from file where game_id "
                  "= :game_id and file_type = :file_type order by file_idx"},
+    {QUERY_GAME_ALL, "select game_id, name, description, dat_idx, parent from game order by game_id"},
     {QUERY_GAME_ID, "select game_id from game where name = :name"},
     {QUERY_GAME, "select game_id, description, dat_idx, parent from game where name = :name"},
     {QUERY_HAS_FILE_TYPE, "select file_idx from file where file_type = :file_type limit 1"},
@@ -287,8 +306,12 @@ RomDB::RomDB(const std::string& name, int mode) : DB(format, name, mode) {
         detectors[detector_id] = read_detector();
     }
 
+    if ((mode & DBH_WRITE) == 0 && !name.starts_with(':')) {
+        snapshot = RomDBSnapshot::open(name, this);
+    }
+
     for (size_t i = 0; i < TYPE_MAX; i++) {
-        has_types[i] = get_has_type(i);
+        has_types[i] = snapshot ? snapshot->has_type(static_cast<filetype_t>(i)) : get_has_type(i);
     }
 }
 
@@ -296,6 +319,11 @@ RomDB::RomDB(const std::string& name, int mode) : DB(format, name, mode) {
 void RomDB::read_hashtypes(filetype_t ft) {
     int type;
 
+    if (snapshot) {
+        hashtypes_[ft] = snapshot->hashtypes(ft);
+        return;
+    }
+
     hashtypes_[ft] = 0;
 
     for (type = 0; (1 << type) <= Hashes::TYPE_MAX; type++) {
@@ -339,6 +367,7 @@ std::vector<DatEntry> RomDB::read_dat() {
         de.description = stmt->get_string("description");
         de.version = stmt->get_string("version");
         de.crc = stmt->get_uint64("crc");
+        de.options = stmt->get_uint64("options");
 
         dat.push_back(de);
     }
@@ -431,6 +460,12 @@ bool RomDB::read_rules(Detector* detector) {
 
 
 std::vector<RomLocation> RomDB::read_file_by_hash(filetype_t ft, const Hashes& hashes) {
+    if (snapshot) {
+        if (auto result = snapshot->read_file_by_hash(this, ft, hashes)) {
+            return *result;
+        }
+    }
+
     auto stmt = get_statement(QUERY_FILE_FBH, hashes, false);
 
     stmt->set_int("file_type", ft);
@@ -456,6 +491,10 @@ std::vector<RomLocation> RomDB::read_file_by_hash(filetype_t ft, const Hashes& h
 static std::string chd_extension = ".chd";
 
 GamePtr RomDB::read_game(const std::string& name) {
+    if (snapshot) {
+        return snapshot->read_game(name);
+    }
+
     auto stmt = get_statement(QUERY_GAME);
 
     stmt->set_string("name", name);
@@ -488,6 +527,60 @@ GamePtr RomDB::read_game(const std::string& name) {
 }
 
 
+void RomDB::read_games(std::deque<Game>& games) {
+    if (snapshot) {
+        snapshot->read_games(games);
+        return;
+    }
+
+    auto stmt = get_statement(QUERY_GAME_ALL);
+
+    while (stmt->step()) {
+        auto& game = games.emplace_back();
+        game.id = stmt->get_uint64("game_id");
+        game.name = stmt->get_string("name");
+        game.description = stmt->get_string("description");
+        game.dat_no = static_cast<unsigned int>(stmt->get_int("dat_idx"));
+        game.cloneof[0] = stmt->get_string("parent");
+    }
+
+    if (games.empty()) {
+        return;
+    }
+
+    /* Both queries are ordered by game_id, so files can be attached in a single merge pass. */
+    auto game = games.begin();
+    stmt = get_statement(QUERY_FILE_ALL);
+
+    while (stmt->step()) {
+        auto game_id = stmt->get_uint64("game_id");
+        while (game != games.end() && game->id < game_id) {
+            ++game;
+        }
+        if (game == games.end()) {
+            break;
+        }
+        if (game->id != game_id) {
+            continue;
+        }
+
+        auto ft = stmt->get_int("file_type");
+        if (ft < 0 || ft >= TYPE_MAX) {
+            continue;
+        }
+
+        Rom& rom = game->files[ft].emplace_back();
+        rom.name = stmt->get_string("name");
+        rom.merge = stmt->get_string("merge");
+        rom.status = static_cast<Rom::Status>(stmt->get_int("status"));
+        rom.where = static_cast<where_t>(stmt->get_int("location"));
+        rom.mia = stmt->get_bool("missing");
+        rom.hashes = stmt->get_hashes();
+        rom.hashes.size = stmt->get_uint64("size", Hashes::SIZE_UNKNOWN);
+    }
+}
+
+
 void RomDB::read_files(Game* game, filetype_t ft) {
     auto stmt = get_statement(QUERY_FILE);
 
@@ -519,6 +612,10 @@ std::vector<std::string> RomDB::read_list(enum dbh_list type) {
         throw Exception("unknown type {}", static_cast<int>(type));
     }
 
+    if (snapshot) {
+        return snapshot->read_list(type);
+    }
+
     auto stmt = get_statement(it->second);
 
     std::vector<std::string> result;
@@ -545,6 +642,7 @@ void RomDB::write_dat(size_t dat_idx, const DatEntry& dat) {
     stmt->set_string("description", dat.description);
     stmt->set_string("version", dat.version);
     stmt->set_uint64("crc", dat.crc);
+    stmt->set_uint64("options", dat.options);
     stmt->execute();
     stmt->reset();
 }
@@ -616,6 +714,14 @@ void RomDB::write_rules(const Detector& detector) {
 }
 
 
+void RomDB::delete_dat(size_t dat_idx) {
+    auto stmt = get_statement(DELETE_DAT);
+
+    stmt->set_int("dat_idx", static_cast<int>(dat_idx));
+    stmt->execute();
+}
+
+
 void RomDB::delete_game(const std::string& name) {
     auto stmt = get_statement(QUERY_GAME_ID);
 
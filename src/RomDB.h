@@ -34,16 +34,19 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <deque>
 #include <unordered_set>
 
 #include "DB.h"
 #include "OutputContext.h"
+#include "RomDBSnapshot.h"
 #include "RomLocation.h"
 #include "Stats.h"
 
 class RomDB : public DB {
   public:
     enum Statement {
+        DELETE_DAT,
         DELETE_FILE,
         DELETE_GAME,
         INSERT_DAT_DETECTOR,
@@ -55,8 +58,10 @@ class RomDB : public DB {
         QUERY_CLONES,
         QUERY_DAT_DETECTOR,
         QUERY_DAT,
+        QUERY_FILE_ALL,
         QUERY_FILE_FBN,
         QUERY_FILE,
+        QUERY_GAME_ALL,
         QUERY_GAME_ID,
         QUERY_GAME,
         QUERY_HAS_FILE_TYPE,
@@ -128,6 +133,7 @@ class RomDB : public DB {
     Stats get_stats();
     uint64_t games_from_dat(size_t dat_idx);
     std::vector<std::string> get_clones(const std::string& game_name);
+    void delete_dat(size_t dat_idx);
     void delete_game(const Game* game) { delete_game(game->name); }
     void delete_game(const std::string& name);
     bool has_type(filetype_t type) const { return has_types[type]; }
@@ -141,6 +147,7 @@ class RomDB : public DB {
     std::vector<DatEntry> read_dat();
     std::vector<RomLocation> read_file_by_hash(filetype_t ft, const Hashes& hashes);
     GamePtr read_game(const std::string& name);
+    void read_games(std::deque<Game>& games);
     int hashtypes(filetype_t);
     FileTypes filetypes();
     std::vector<std::string> read_list(enum dbh_list type);
@@ -160,6 +167,7 @@ class RomDB : public DB {
 
   private:
     int hashtypes_[TYPE_MAX];
+    std::unique_ptr<RomDBSnapshot> snapshot;
 
     static const std::string init2_sql;
     static const Statement query_hash_type[];
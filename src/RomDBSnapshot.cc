@@ -0,0 +1,719 @@
+/*
+  RomDBSnapshot.cc -- compiled read-only copy of ROM database
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "RomDBSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "config.h"
+
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <zlib.h>
+
+#include "Exception.h"
+#include "RomDB.h"
+#include "file_util.h"
+
+// bump version on change of any record layout
+static const char snapshot_magic[8] = {'c', 'k', 'm', 's', 'n', 'a', 'p', '\0'};
+static const uint32_t snapshot_version = 2;
+static const uint32_t snapshot_byte_order = 0x01020304;
+
+// CRC, MD5, SHA1, SHA256; hash type is 1 << index
+static const size_t hash_type_count = 4;
+
+
+class RomDBSnapshot::StringReference {
+  public:
+    uint32_t offset;
+    uint32_t length;
+};
+
+
+class RomDBSnapshot::Section {
+  public:
+    uint64_t offset;
+    uint64_t count;
+};
+
+
+class RomDBSnapshot::GameRecord {
+  public:
+    uint64_t id;
+    StringReference name;
+    StringReference description;
+    StringReference parent;
+    uint32_t dat_no;
+    uint32_t mia;
+    uint32_t first_file[TYPE_MAX];
+    uint32_t file_count[TYPE_MAX];
+};
+
+
+class RomDBSnapshot::FileRecord {
+  public:
+    StringReference name;
+    StringReference merge;
+    uint64_t size;
+    uint32_t game;
+    uint32_t index;
+    uint8_t file_type;
+    uint8_t status;
+    int8_t where;
+    uint8_t mia;
+    uint8_t hash_types;
+    uint8_t crc[Hashes::SIZE_CRC]; // big endian
+    uint8_t md5[Hashes::SIZE_MD5];
+    uint8_t sha1[Hashes::SIZE_SHA1];
+    uint8_t sha256[Hashes::SIZE_SHA256];
+
+    [[nodiscard]] const uint8_t* hash(int type) const { return const_cast<FileRecord*>(this)->hash(type); }
+    uint8_t* hash(int type) {
+        switch (type) {
+        case Hashes::TYPE_CRC:
+            return crc;
+        case Hashes::TYPE_MD5:
+            return md5;
+        case Hashes::TYPE_SHA1:
+            return sha1;
+        default:
+            return sha256;
+        }
+    }
+};
+
+
+class RomDBSnapshot::Header {
+  public:
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t game_record_size;
+    uint32_t file_record_size;
+    uint64_t db_size;
+    int64_t db_mtime;
+    uint32_t dat_count;
+    uint32_t dats_checksum;
+    uint32_t has_type[TYPE_MAX];
+    uint32_t hashtypes[TYPE_MAX];
+    Section games;         // GameRecord, in database order
+    Section games_by_name; // uint32_t game index, sorted by name
+    Section files;         // FileRecord, grouped by game, then by file type
+    Section disk_names;    // StringReference, sorted, without duplicates
+    Section strings;       // characters
+    Section hash_index[TYPE_MAX][hash_type_count];   // uint32_t file index of files with hash, sorted by hash
+    Section hash_missing[TYPE_MAX][hash_type_count]; // uint32_t file index of files without hash, in order
+};
+
+
+static void hash_bytes(const Hashes& hashes, int type, uint8_t* bytes) {
+    switch (type) {
+    case Hashes::TYPE_CRC:
+        bytes[0] = static_cast<uint8_t>(hashes.crc >> 24);
+        bytes[1] = static_cast<uint8_t>(hashes.crc >> 16);
+        bytes[2] = static_cast<uint8_t>(hashes.crc >> 8);
+        bytes[3] = static_cast<uint8_t>(hashes.crc);
+        break;
+    case Hashes::TYPE_MD5:
+        memcpy(bytes, hashes.md5.data(), Hashes::SIZE_MD5);
+        break;
+    case Hashes::TYPE_SHA1:
+        memcpy(bytes, hashes.sha1.data(), Hashes::SIZE_SHA1);
+        break;
+    case Hashes::TYPE_SHA256:
+        memcpy(bytes, hashes.sha256.data(), Hashes::SIZE_SHA256);
+        break;
+    }
+}
+
+
+static bool get_db_stamp(const std::filesystem::path& db_file_name, uint64_t* size, int64_t* mtime) {
+    std::error_code ec;
+
+    *size = std::filesystem::file_size(db_file_name, ec);
+    if (ec) {
+        return false;
+    }
+    auto time = std::filesystem::last_write_time(db_file_name, ec);
+    if (ec) {
+        return false;
+    }
+    *mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+
+// Identify the dats of the database, so a snapshot of a different database is not used even if size and modification
+// time happen to match.
+static uint32_t get_dats_checksum(const std::vector<DatEntry>& dats) {
+    std::string data;
+    for (const auto& dat : dats) {
+        data += dat.name;
+        data += '\0';
+        data += dat.version;
+        data += '\0';
+        data += std::to_string(dat.crc);
+        data += '\0';
+    }
+
+    return static_cast<uint32_t>(
+        crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())));
+}
+
+
+std::vector<uint8_t> RomDBSnapshot::compile(RomDB* db) {
+    std::deque<Game> games;
+    db->read_games(games);
+
+    std::string strings;
+    std::unordered_map<std::string, uint32_t> string_offsets;
+    auto add_string = [&strings, &string_offsets](const std::string& string) -> StringReference {
+        if (string.empty()) {
+            return {0, 0};
+        }
+        auto [it, inserted] = string_offsets.try_emplace(string, static_cast<uint32_t>(strings.size()));
+        if (inserted) {
+            if (strings.size() + string.size() > UINT32_MAX) {
+                throw Exception("ROM database too large for snapshot");
+            }
+            strings += string;
+        }
+        return {it->second, static_cast<uint32_t>(string.size())};
+    };
+
+    Header header{};
+    memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = snapshot_version;
+    header.byte_order = snapshot_byte_order;
+    header.game_record_size = sizeof(GameRecord);
+    header.file_record_size = sizeof(FileRecord);
+    auto dats = db->read_dat();
+    header.dat_count = static_cast<uint32_t>(dats.size());
+    header.dats_checksum = get_dats_checksum(dats);
+
+    std::vector<GameRecord> game_records;
+    std::vector<FileRecord> file_records;
+    std::vector<std::string> disk_names;
+
+    for (const auto& game : games) {
+        GameRecord game_record{};
+        game_record.id = game.id;
+        game_record.name = add_string(game.name);
+        game_record.description = add_string(game.description);
+        game_record.parent = add_string(game.cloneof[0]);
+        game_record.dat_no = static_cast<uint32_t>(game.dat_no);
+
+        for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+            game_record.first_file[ft] = static_cast<uint32_t>(file_records.size());
+            game_record.file_count[ft] = static_cast<uint32_t>(game.files[ft].size());
+
+            for (size_t index = 0; index < game.files[ft].size(); index++) {
+                const auto& rom = game.files[ft][index];
+                FileRecord file_record{};
+
+                file_record.name = add_string(rom.name);
+                file_record.merge = add_string(rom.merge);
+                file_record.size = rom.hashes.size;
+                file_record.game = static_cast<uint32_t>(game_records.size());
+                file_record.index = static_cast<uint32_t>(index);
+                file_record.file_type = static_cast<uint8_t>(ft);
+                file_record.status = static_cast<uint8_t>(rom.status);
+                file_record.where = static_cast<int8_t>(rom.where);
+                file_record.mia = rom.mia;
+                file_record.hash_types = static_cast<uint8_t>(rom.hashes.get_types());
+                for (size_t i = 0; i < hash_type_count; i++) {
+                    auto type = 1 << i;
+                    if (rom.hashes.has_type(type)) {
+                        hash_bytes(rom.hashes, type, file_record.hash(type));
+                    }
+                }
+
+                if (rom.mia) {
+                    game_record.mia = 1;
+                }
+                if (ft == TYPE_DISK) {
+                    disk_names.push_back(rom.name);
+                }
+                header.has_type[ft] = 1;
+                header.hashtypes[ft] |= file_record.hash_types;
+
+                file_records.push_back(file_record);
+            }
+        }
+
+        game_records.push_back(game_record);
+    }
+
+    if (file_records.size() > UINT32_MAX) {
+        throw Exception("ROM database too large for snapshot");
+    }
+
+    std::vector<uint32_t> games_by_name(game_records.size());
+    for (size_t i = 0; i < games_by_name.size(); i++) {
+        games_by_name[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(games_by_name.begin(), games_by_name.end(),
+              [&games](uint32_t a, uint32_t b) { return games[a].name < games[b].name; });
+
+    std::sort(disk_names.begin(), disk_names.end());
+    disk_names.erase(std::unique(disk_names.begin(), disk_names.end()), disk_names.end());
+    std::vector<StringReference> disk_name_references;
+    for (const auto& name : disk_names) {
+        disk_name_references.push_back(add_string(name));
+    }
+
+    std::vector<uint32_t> hash_index[TYPE_MAX][hash_type_count];
+    std::vector<uint32_t> hash_missing[TYPE_MAX][hash_type_count];
+    for (size_t i = 0; i < file_records.size(); i++) {
+        const auto& file_record = file_records[i];
+        for (size_t type_index = 0; type_index < hash_type_count; type_index++) {
+            if (file_record.hash_types & (1 << type_index)) {
+                hash_index[file_record.file_type][type_index].push_back(static_cast<uint32_t>(i));
+            }
+            else {
+                hash_missing[file_record.file_type][type_index].push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        for (size_t type_index = 0; type_index < hash_type_count; type_index++) {
+            auto type = 1 << type_index;
+            auto length = Hashes::hash_size(type);
+            std::stable_sort(hash_index[ft][type_index].begin(), hash_index[ft][type_index].end(),
+                             [&file_records, type, length](uint32_t a, uint32_t b) {
+                                 return memcmp(file_records[a].hash(type), file_records[b].hash(type), length) < 0;
+                             });
+        }
+    }
+
+    std::vector<uint8_t> data(sizeof(Header));
+    auto add_section = [&data](Section* section, const void* elements, size_t count, size_t element_size) {
+        data.resize((data.size() + 7) & ~static_cast<size_t>(7));
+        section->offset = data.size();
+        section->count = count;
+        auto bytes = static_cast<const uint8_t*>(elements);
+        data.insert(data.end(), bytes, bytes + count * element_size);
+    };
+
+    add_section(&header.games, game_records.data(), game_records.size(), sizeof(GameRecord));
+    add_section(&header.games_by_name, games_by_name.data(), games_by_name.size(), sizeof(uint32_t));
+    add_section(&header.files, file_records.data(), file_records.size(), sizeof(FileRecord));
+    add_section(&header.disk_names, disk_name_references.data(), disk_name_references.size(),
+                sizeof(StringReference));
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        for (size_t type_index = 0; type_index < hash_type_count; type_index++) {
+            add_section(&header.hash_index[ft][type_index], hash_index[ft][type_index].data(),
+                        hash_index[ft][type_index].size(), sizeof(uint32_t));
+            add_section(&header.hash_missing[ft][type_index], hash_missing[ft][type_index].data(),
+                        hash_missing[ft][type_index].size(), sizeof(uint32_t));
+        }
+    }
+    add_section(&header.strings, strings.data(), strings.size(), 1);
+
+    memcpy(data.data(), &header, sizeof(header));
+
+    return data;
+}
+
+
+void RomDBSnapshot::write(const std::filesystem::path& db_file_name, std::vector<uint8_t> data) {
+    auto header = reinterpret_cast<Header*>(data.data());
+    if (!get_db_stamp(db_file_name, &header->db_size, &header->db_mtime)) {
+        throw Exception("cannot get size of '{}'", db_file_name.string());
+    }
+
+    auto name = file_name(db_file_name);
+    auto temp_name = make_unique_path(name.string() + "-tmp");
+
+    {
+        std::ofstream stream(temp_name, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        stream.close();
+        if (!stream) {
+            std::error_code ec;
+            std::filesystem::remove(temp_name, ec);
+            throw Exception("cannot write '{}'", temp_name.string()).append_system_error();
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_name, name, ec);
+    if (ec) {
+        auto message = ec.message();
+        std::filesystem::remove(temp_name, ec);
+        throw Exception("cannot rename '{}' to '{}': {}", temp_name.string(), name.string(), message);
+    }
+}
+
+
+void RomDBSnapshot::remove(const std::filesystem::path& db_file_name) {
+    std::error_code ec;
+    std::filesystem::remove(file_name(db_file_name), ec);
+}
+
+
+void RomDBSnapshot::rename(const std::filesystem::path& old_db_file_name,
+                           const std::filesystem::path& new_db_file_name) {
+    std::error_code ec;
+    std::filesystem::rename(file_name(old_db_file_name), file_name(new_db_file_name), ec);
+    if (ec) {
+        std::filesystem::remove(file_name(old_db_file_name), ec);
+        std::filesystem::remove(file_name(new_db_file_name), ec);
+    }
+}
+
+
+std::unique_ptr<RomDBSnapshot> RomDBSnapshot::open(const std::filesystem::path& db_file_name, RomDB* db) {
+    auto snapshot = std::unique_ptr<RomDBSnapshot>(new RomDBSnapshot());
+    auto name = file_name(db_file_name);
+
+#ifdef HAVE_MMAP
+    auto fd = ::open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return nullptr;
+    }
+    auto mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    snapshot->data = static_cast<const uint8_t*>(mapping);
+    snapshot->size = static_cast<size_t>(st.st_size);
+    snapshot->mapped = true;
+#else
+    std::ifstream stream(name, std::ios::binary);
+    if (!stream) {
+        return nullptr;
+    }
+    snapshot->buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    snapshot->data = snapshot->buffer.data();
+    snapshot->size = snapshot->buffer.size();
+#endif
+
+    if (!snapshot->validate(db_file_name, db)) {
+        return nullptr;
+    }
+
+    return snapshot;
+}
+
+
+RomDBSnapshot::~RomDBSnapshot() {
+#ifdef HAVE_MMAP
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+}
+
+
+bool RomDBSnapshot::validate(const std::filesystem::path& db_file_name, RomDB* db) const {
+    if (size < sizeof(Header)) {
+        return false;
+    }
+
+    auto h = header();
+    if (memcmp(h->magic, snapshot_magic, sizeof(h->magic)) != 0 || h->version != snapshot_version ||
+        h->byte_order != snapshot_byte_order || h->game_record_size != sizeof(GameRecord) ||
+        h->file_record_size != sizeof(FileRecord)) {
+        return false;
+    }
+
+    uint64_t db_size;
+    int64_t db_mtime;
+    if (!get_db_stamp(db_file_name, &db_size, &db_mtime) || db_size != h->db_size || db_mtime != h->db_mtime) {
+        return false;
+    }
+
+    auto dats = db->read_dat();
+    if (dats.size() != h->dat_count || get_dats_checksum(dats) != h->dats_checksum) {
+        return false;
+    }
+
+    auto section_ok = [this](const Section& section, size_t element_size) {
+        return section.offset % 8 == 0 && section.offset <= size &&
+               section.count <= (size - section.offset) / element_size;
+    };
+
+    if (!section_ok(h->games, sizeof(GameRecord)) || !section_ok(h->games_by_name, sizeof(uint32_t)) ||
+        !section_ok(h->files, sizeof(FileRecord)) || !section_ok(h->disk_names, sizeof(StringReference)) ||
+        !section_ok(h->strings, 1) || h->games_by_name.count != h->games.count) {
+        return false;
+    }
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        for (size_t type_index = 0; type_index < hash_type_count; type_index++) {
+            if (!section_ok(h->hash_index[ft][type_index], sizeof(uint32_t)) ||
+                !section_ok(h->hash_missing[ft][type_index], sizeof(uint32_t))) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+template <typename T> const T* RomDBSnapshot::section(const Section& section) const {
+    return reinterpret_cast<const T*>(data + section.offset);
+}
+
+
+std::string_view RomDBSnapshot::string(const StringReference& reference) const {
+    if (static_cast<uint64_t>(reference.offset) + reference.length > header()->strings.count) {
+        throw Exception("invalid string in ROM database snapshot");
+    }
+    return {reinterpret_cast<const char*>(data + header()->strings.offset + reference.offset), reference.length};
+}
+
+
+const RomDBSnapshot::GameRecord* RomDBSnapshot::game(uint64_t index) const {
+    if (index >= header()->games.count) {
+        throw Exception("invalid game in ROM database snapshot");
+    }
+    return section<GameRecord>(header()->games) + index;
+}
+
+
+const RomDBSnapshot::FileRecord* RomDBSnapshot::file(uint64_t index) const {
+    if (index >= header()->files.count) {
+        throw Exception("invalid file in ROM database snapshot");
+    }
+    return section<FileRecord>(header()->files) + index;
+}
+
+
+const RomDBSnapshot::GameRecord* RomDBSnapshot::find_game(std::string_view name) const {
+    auto by_name = section<uint32_t>(header()->games_by_name);
+    auto end = by_name + header()->games_by_name.count;
+
+    auto it = std::lower_bound(by_name, end, name, [this](uint32_t index, std::string_view value) {
+        return string(game(index)->name) < value;
+    });
+    if (it == end || string(game(*it)->name) != name) {
+        return nullptr;
+    }
+    return game(*it);
+}
+
+
+Hashes RomDBSnapshot::hashes(const FileRecord* file) const {
+    Hashes hashes;
+
+    if (file->hash_types & Hashes::TYPE_CRC) {
+        hashes.set_crc(static_cast<uint32_t>(file->crc[0]) << 24 | static_cast<uint32_t>(file->crc[1]) << 16 |
+                       static_cast<uint32_t>(file->crc[2]) << 8 | static_cast<uint32_t>(file->crc[3]));
+    }
+    if (file->hash_types & Hashes::TYPE_MD5) {
+        hashes.set_md5(file->md5);
+    }
+    if (file->hash_types & Hashes::TYPE_SHA1) {
+        hashes.set_sha1(file->sha1);
+    }
+    if (file->hash_types & Hashes::TYPE_SHA256) {
+        hashes.set_sha256(file->sha256);
+    }
+    hashes.size = file->size;
+
+    return hashes;
+}
+
+
+bool RomDBSnapshot::has_type(filetype_t type) const { return header()->has_type[type] != 0; }
+
+
+int RomDBSnapshot::hashtypes(filetype_t type) const { return static_cast<int>(header()->hashtypes[type]); }
+
+
+std::optional<std::vector<RomLocation>> RomDBSnapshot::read_file_by_hash(const RomDB* db, filetype_t ft,
+                                                                         const Hashes& hashes) const {
+    auto types = hashes.get_types();
+    if (types == 0) {
+        return {};
+    }
+
+    size_t type_index = 0;
+    while ((types & (1 << type_index)) == 0) {
+        type_index++;
+    }
+    auto type = 1 << type_index;
+    auto length = Hashes::hash_size(type);
+    uint8_t value[Hashes::MAX_SIZE];
+    hash_bytes(hashes, type, value);
+
+    // Files without the hash match as well, like NULL columns in the SQL query.
+    auto index = section<uint32_t>(header()->hash_index[ft][type_index]);
+    auto index_end = index + header()->hash_index[ft][type_index].count;
+    auto [first, last] = std::equal_range(
+        index, index_end, static_cast<uint32_t>(UINT32_MAX),
+        [this, type, length, &value](uint32_t a, uint32_t b) {
+            auto hash_a = a == UINT32_MAX ? value : file(a)->hash(type);
+            auto hash_b = b == UINT32_MAX ? value : file(b)->hash(type);
+            return memcmp(hash_a, hash_b, length) < 0;
+        });
+    auto missing = section<uint32_t>(header()->hash_missing[ft][type_index]);
+    std::vector<uint32_t> candidates(first, last);
+    candidates.insert(candidates.end(), missing, missing + header()->hash_missing[ft][type_index].count);
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<RomLocation> result;
+
+    for (auto candidate : candidates) {
+        auto file_record = file(candidate);
+
+        if (file_record->status == Rom::NO_DUMP) {
+            continue;
+        }
+
+        auto match = true;
+        for (size_t i = 0; i < hash_type_count; i++) {
+            auto other_type = 1 << i;
+            if ((types & other_type) && (file_record->hash_types & other_type)) {
+                uint8_t other_value[Hashes::MAX_SIZE];
+                hash_bytes(hashes, other_type, other_value);
+                if (memcmp(file_record->hash(other_type), other_value, Hashes::hash_size(other_type)) != 0) {
+                    match = false;
+                    break;
+                }
+            }
+        }
+        if (!match) {
+            continue;
+        }
+
+        // Only name, hashes, and size are filled in, like in RomDB::read_file_by_hash.
+        auto game_record = game(file_record->game);
+        auto rom = Rom();
+        rom.name = string(file_record->name);
+        rom.hashes = this->hashes(file_record);
+        result.emplace_back(std::string(string(game_record->name)), db->get_detector_id_for_dat(game_record->dat_no),
+                            file_record->index, rom);
+    }
+
+    return result;
+}
+
+
+GamePtr RomDBSnapshot::read_game(const std::string& name) const {
+    auto game_record = find_game(name);
+    if (game_record == nullptr) {
+        return nullptr;
+    }
+
+    auto game = std::make_shared<Game>();
+    read_game(game_record, game.get());
+
+    if (!game->cloneof[0].empty()) {
+        if (auto parent = find_game(game->cloneof[0])) {
+            game->cloneof[1] = string(parent->parent);
+        }
+    }
+
+    return game;
+}
+
+
+void RomDBSnapshot::read_games(std::deque<Game>& games) const {
+    for (uint64_t index = 0; index < header()->games.count; index++) {
+        read_game(game(index), &games.emplace_back());
+    }
+}
+
+
+void RomDBSnapshot::read_game(const GameRecord* game_record, Game* game) const {
+    game->id = game_record->id;
+    game->name = string(game_record->name);
+    game->description = string(game_record->description);
+    game->dat_no = game_record->dat_no;
+    game->cloneof[0] = string(game_record->parent);
+
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        for (uint64_t i = 0; i < game_record->file_count[ft]; i++) {
+            auto file_record = file(static_cast<uint64_t>(game_record->first_file[ft]) + i);
+            auto& rom = game->files[ft].emplace_back();
+
+            rom.name = string(file_record->name);
+            rom.merge = string(file_record->merge);
+            rom.status = static_cast<Rom::Status>(file_record->status);
+            rom.where = static_cast<where_t>(file_record->where);
+            rom.mia = file_record->mia != 0;
+            rom.hashes = hashes(file_record);
+        }
+    }
+}
+
+
+std::vector<std::string> RomDBSnapshot::read_list(enum dbh_list type) const {
+    std::vector<std::string> result;
+
+    switch (type) {
+    case DBH_KEY_LIST_DISK: {
+        auto names = section<StringReference>(header()->disk_names);
+        for (uint64_t i = 0; i < header()->disk_names.count; i++) {
+            result.emplace_back(string(names[i]));
+        }
+        break;
+    }
+
+    case DBH_KEY_LIST_GAME:
+    case DBH_KEY_LIST_MIA: {
+        auto by_name = section<uint32_t>(header()->games_by_name);
+        for (uint64_t i = 0; i < header()->games_by_name.count; i++) {
+            auto game_record = game(by_name[i]);
+            if (type == DBH_KEY_LIST_MIA && !game_record->mia) {
+                continue;
+            }
+            result.emplace_back(string(game_record->name));
+        }
+        break;
+    }
+
+    default:
+        throw Exception("unknown type {}", static_cast<int>(type));
+    }
+
+    return result;
+}
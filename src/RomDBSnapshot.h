@@ -0,0 +1,156 @@
+/*
+  RomDBSnapshot.h -- compiled read-only copy of ROM database
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef HAD_ROMDB_SNAPSHOT_H
+#define HAD_ROMDB_SNAPSHOT_H
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "DB.h"
+#include "Game.h"
+#include "RomLocation.h"
+
+class RomDB;
+
+/**
+ * Compiled read-only copy of a ROM database, stored next to it.
+ *
+ * The snapshot is mapped into memory and answers game, list, and hash lookups without going through SQLite. It records
+ * size and modification time of the database it was compiled from, as well as a checksum of its dats, and is ignored
+ * if they don't match.
+ */
+class RomDBSnapshot {
+  public:
+    /**
+     * Compile a snapshot of a ROM database.
+     *
+     * The result is written with `write()` once the database file is in its final place.
+     *
+     * @param db The ROM database.
+     * @return The compiled snapshot.
+     */
+    static std::vector<uint8_t> compile(RomDB* db);
+
+    /**
+     * Open the snapshot of a ROM database.
+     *
+     * @param db_file_name The file name of the ROM database.
+     * @param db The ROM database, used to check that the snapshot was compiled from it.
+     * @return The snapshot, or nullptr if there is none or it doesn't match the database.
+     */
+    static std::unique_ptr<RomDBSnapshot> open(const std::filesystem::path& db_file_name, RomDB* db);
+
+    /**
+     * Remove the snapshot of a ROM database, if there is one.
+     *
+     * @param db_file_name The file name of the ROM database.
+     */
+    static void remove(const std::filesystem::path& db_file_name);
+
+    /**
+     * Move the snapshot along with its ROM database.
+     *
+     * @param old_db_file_name The previous file name of the ROM database.
+     * @param new_db_file_name The new file name of the ROM database.
+     */
+    static void rename(const std::filesystem::path& old_db_file_name, const std::filesystem::path& new_db_file_name);
+
+    /**
+     * Write a compiled snapshot for a ROM database.
+     *
+     * @param db_file_name The file name of the ROM database.
+     * @param data The snapshot, as returned by `compile()`.
+     */
+    static void write(const std::filesystem::path& db_file_name, std::vector<uint8_t> data);
+
+    RomDBSnapshot(const RomDBSnapshot&) = delete;
+    RomDBSnapshot& operator=(const RomDBSnapshot&) = delete;
+    ~RomDBSnapshot();
+
+    [[nodiscard]] bool has_type(filetype_t type) const;
+    [[nodiscard]] int hashtypes(filetype_t type) const;
+
+    /**
+     * Find files by hashes, like `RomDB::read_file_by_hash()`.
+     *
+     * @param db The ROM database the snapshot belongs to, used to map dats to detectors.
+     * @param ft The type of files to find.
+     * @param hashes The hashes to look for.
+     * @return The matching files, or no value if the lookup can't be done with the snapshot.
+     */
+    std::optional<std::vector<RomLocation>> read_file_by_hash(const RomDB* db, filetype_t ft,
+                                                              const Hashes& hashes) const;
+    GamePtr read_game(const std::string& name) const;
+    /**
+     * Read all games, like `RomDB::read_games()`.
+     *
+     * @param games Games are appended here, in database order.
+     */
+    void read_games(std::deque<Game>& games) const;
+    std::vector<std::string> read_list(enum dbh_list type) const;
+
+  private:
+    class FileRecord;
+    class GameRecord;
+    class Header;
+    class Section;
+    class StringReference;
+
+    RomDBSnapshot() = default;
+
+    const uint8_t* data{nullptr};
+    size_t size{0};
+    bool mapped{false};
+    std::vector<uint8_t> buffer;
+
+    static std::filesystem::path file_name(const std::filesystem::path& db_file_name) {
+        return db_file_name.string() + ".snapshot";
+    }
+
+    [[nodiscard]] const Header* header() const { return reinterpret_cast<const Header*>(data); }
+    template <typename T> [[nodiscard]] const T* section(const Section& section) const;
+    [[nodiscard]] const GameRecord* find_game(std::string_view name) const;
+    [[nodiscard]] const FileRecord* file(uint64_t index) const;
+    [[nodiscard]] const GameRecord* game(uint64_t index) const;
+    void read_game(const GameRecord* game_record, Game* game) const;
+    [[nodiscard]] Hashes hashes(const FileRecord* file) const;
+    [[nodiscard]] std::string_view string(const StringReference& reference) const;
+    [[nodiscard]] bool validate(const std::filesystem::path& db_file_name, RomDB* db) const;
+};
+
+#endif // HAD_ROMDB_SNAPSHOT_H
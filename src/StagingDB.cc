@@ -0,0 +1,353 @@
+/*
+  StagingDB.cc -- temporary database of games while writing output
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "StagingDB.h"
+
+const DB::DBFormat StagingDB::format = {0x4,
+                                        1,
+                                        "\
+create table game (\n\
+    game_id integer primary key autoincrement,\n\
+    name text not null,\n\
+    original_name text,\n\
+    description text,\n\
+    dat_no integer not null,\n\
+    parent text,\n\
+    grandparent text,\n\
+    fingerprint integer not null,\n\
+    fixed integer not null default 0\n\
+);\n\
+create index game_name on game (name, fingerprint);\n\
+create index game_original_name on game (dat_no, original_name);\n\
+\n\
+create table file (\n\
+    game_id integer,\n\
+    file_type integer,\n\
+    file_idx integer,\n\
+    name text not null,\n\
+    merge text,\n\
+    status integer not null,\n\
+    location integer not null,\n\
+    size integer,\n\
+    crc integer,\n\
+    md5 binary,\n\
+    sha1 binary,\n\
+    sha256 binary,\n\
+    missing integer not null,\n\
+    mtime integer not null,\n\
+    primary key (game_id, file_type, file_idx)\n\
+);\n",
+                                        {},
+                                        // written once and read back in passes; not worth syncing
+                                        {false, 16 * 1024, 0}};
+
+std::unordered_map<StagingDB::Statement, std::string> StagingDB::queries = {
+    {DELETE_FILES_BY_NAME, "delete from file where game_id in (select game_id from game where name = :name)"},
+    {DELETE_GAMES_BY_NAME, "delete from game where name = :name"},
+    {INSERT_FILE, "insert into file (game_id, file_type, file_idx, name, merge, status, location, size, crc, md5, "
+                  "sha1, sha256, missing, mtime) values (:game_id, :file_type, :file_idx, :name, :merge, :status, "
+                  ":location, :size, :crc, :md5, :sha1, :sha256, :missing, :mtime)"},
+    {INSERT_GAME, "insert into game (name, original_name, description, dat_no, parent, grandparent, fingerprint) "
+                  "values (:name, :original_name, :description, :dat_no, :parent, :grandparent, :fingerprint)"},
+    {LIST_DUPLICATE_NAMES, "select name from game group by name having count(*) > 1"},
+    {LIST_GAMES_BY_NAME, "select game_id from game where name = :name order by game_id"},
+    {LIST_GAMES_BY_NAME_FINGERPRINT,
+     "select game_id from game where name = :name and fingerprint = :fingerprint order by game_id"},
+    {LIST_GAMES_SORTED, "select max(game_id) as game_id from game group by name order by name"},
+    {QUERY_FILES, "select file_type, name, merge, status, location, size, crc, md5, sha1, sha256, missing, mtime from "
+                  "file where game_id = :game_id order by file_type, file_idx"},
+    {QUERY_FIXED, "select fixed from game where game_id = :game_id"},
+    {QUERY_GAME, "select name, original_name, description, dat_no, parent, grandparent from game where game_id = "
+                 ":game_id"},
+    {QUERY_GAME_BY_NAME, "select game_id from game where name = :name order by game_id desc limit 1"},
+    {QUERY_NEXT_UNFIXED, "select game_id from game where game_id > :game_id and fixed = 0 order by game_id limit 1"},
+    {QUERY_RENAMED, "select name from game where dat_no = :dat_no and original_name = :original_name and name != "
+                    "original_name order by game_id desc limit 1"},
+    {UPDATE_FILE, "update file set location = :location, missing = :missing where game_id = :game_id and file_type = "
+                  ":file_type and file_idx = :file_idx"},
+    {UPDATE_FIXED, "update game set fixed = 1 where game_id = :game_id"},
+    {UPDATE_GAME, "update game set parent = :parent, grandparent = :grandparent where game_id = :game_id"},
+    {UPDATE_NAME, "update game set name = :name where game_id = :game_id"}};
+
+
+StagingDB::StagingDB(const std::filesystem::path& file_name) : DB(format, file_name.string(), DBH_NEW) {
+    // Never committed, the database is deleted when done.
+    begin_transaction();
+}
+
+
+std::string StagingDB::get_query(int name, bool parameterized) const {
+    if (parameterized) {
+        return "";
+    }
+    else {
+        auto it = queries.find(static_cast<Statement>(name));
+        if (it == queries.end()) {
+            return "";
+        }
+        return it->second;
+    }
+}
+
+
+void StagingDB::insert_game(Game* game, uint64_t fingerprint) {
+    auto stmt = get_statement(INSERT_GAME);
+
+    stmt->set_string("name", game->name, true);
+    stmt->set_string("original_name", game->original_name);
+    stmt->set_string("description", game->description);
+    stmt->set_uint64("dat_no", game->dat_no);
+    stmt->set_string("parent", game->cloneof[0]);
+    stmt->set_string("grandparent", game->cloneof[1]);
+    stmt->set_uint64("fingerprint", fingerprint);
+    stmt->execute();
+
+    game->id = static_cast<uint64_t>(stmt->get_rowid());
+
+    stmt = get_statement(INSERT_FILE);
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        for (size_t i = 0; i < game->files[ft].size(); i++) {
+            auto& rom = game->files[ft][i];
+
+            stmt->set_uint64("game_id", game->id);
+            stmt->set_int("file_type", static_cast<int>(ft));
+            stmt->set_int("file_idx", static_cast<int>(i));
+            stmt->set_string("name", rom.name, true);
+            stmt->set_string("merge", rom.merge);
+            stmt->set_int("status", rom.status);
+            stmt->set_int("location", rom.where);
+            stmt->set_bool("missing", rom.mia);
+            stmt->set_int64("mtime", static_cast<int64_t>(rom.mtime));
+            stmt->set_uint64("size", rom.hashes.size, Hashes::SIZE_UNKNOWN);
+            stmt->set_hashes(rom.hashes, true);
+
+            stmt->execute();
+            stmt->reset();
+        }
+    }
+}
+
+
+void StagingDB::delete_games(const std::string& name) {
+    auto stmt = get_statement(DELETE_FILES_BY_NAME);
+    stmt->set_string("name", name, true);
+    stmt->execute();
+
+    stmt = get_statement(DELETE_GAMES_BY_NAME);
+    stmt->set_string("name", name, true);
+    stmt->execute();
+}
+
+
+GamePtr StagingDB::read_game(const std::string& name) {
+    auto stmt = get_statement(QUERY_GAME_BY_NAME);
+    stmt->set_string("name", name, true);
+
+    if (!stmt->step()) {
+        return nullptr;
+    }
+
+    return read_game(stmt->get_uint64("game_id"));
+}
+
+
+GamePtr StagingDB::read_game(uint64_t id) {
+    auto stmt = get_statement(QUERY_GAME);
+    stmt->set_uint64("game_id", id);
+
+    if (!stmt->step()) {
+        return nullptr;
+    }
+
+    auto game = std::make_shared<Game>();
+    game->id = id;
+    game->name = stmt->get_string("name");
+    game->original_name = stmt->get_string("original_name");
+    game->description = stmt->get_string("description");
+    game->dat_no = stmt->get_uint64("dat_no");
+    game->cloneof[0] = stmt->get_string("parent");
+    game->cloneof[1] = stmt->get_string("grandparent");
+
+    stmt = get_statement(QUERY_FILES);
+    stmt->set_uint64("game_id", id);
+
+    while (stmt->step()) {
+        auto ft = stmt->get_int("file_type");
+        if (ft < 0 || ft >= TYPE_MAX) {
+            continue;
+        }
+
+        Rom& rom = game->files[ft].emplace_back();
+        rom.name = stmt->get_string("name");
+        rom.merge = stmt->get_string("merge");
+        rom.status = static_cast<Rom::Status>(stmt->get_int("status"));
+        rom.where = static_cast<where_t>(stmt->get_int("location"));
+        rom.mia = stmt->get_bool("missing");
+        rom.mtime = static_cast<time_t>(stmt->get_int64("mtime"));
+        rom.hashes = stmt->get_hashes();
+        rom.hashes.size = stmt->get_uint64("size", Hashes::SIZE_UNKNOWN);
+    }
+
+    return game;
+}
+
+
+std::vector<GamePtr> StagingDB::read_games(const std::string& name) {
+    auto stmt = get_statement(LIST_GAMES_BY_NAME);
+    stmt->set_string("name", name, true);
+
+    return read_games(stmt);
+}
+
+
+std::vector<GamePtr> StagingDB::read_games(const std::string& name, uint64_t fingerprint) {
+    auto stmt = get_statement(LIST_GAMES_BY_NAME_FINGERPRINT);
+    stmt->set_string("name", name, true);
+    stmt->set_uint64("fingerprint", fingerprint);
+
+    return read_games(stmt);
+}
+
+
+std::vector<GamePtr> StagingDB::read_games(DBStatement* stmt) {
+    // Ids are collected first, reading games resets other statements.
+    std::vector<uint64_t> ids;
+    while (stmt->step()) {
+        ids.push_back(stmt->get_uint64("game_id"));
+    }
+
+    std::vector<GamePtr> games;
+    for (auto id : ids) {
+        if (auto game = read_game(id)) {
+            games.push_back(game);
+        }
+    }
+
+    return games;
+}
+
+
+GamePtr StagingDB::read_next_unfixed_game(uint64_t id) {
+    auto stmt = get_statement(QUERY_NEXT_UNFIXED);
+    stmt->set_uint64("game_id", id);
+
+    if (!stmt->step()) {
+        return nullptr;
+    }
+
+    return read_game(stmt->get_uint64("game_id"));
+}
+
+
+void StagingDB::for_each_game_sorted(const std::function<void(GamePtr)>& function) {
+    auto stmt = get_statement(LIST_GAMES_SORTED);
+
+    while (stmt->step()) {
+        if (auto game = read_game(stmt->get_uint64("game_id"))) {
+            function(game);
+        }
+    }
+}
+
+
+std::vector<std::string> StagingDB::duplicate_names() {
+    auto stmt = get_statement(LIST_DUPLICATE_NAMES);
+
+    std::vector<std::string> names;
+    while (stmt->step()) {
+        names.push_back(stmt->get_string("name"));
+    }
+
+    return names;
+}
+
+
+std::optional<std::string> StagingDB::renamed_game(size_t dat_no, const std::string& original_name) {
+    auto stmt = get_statement(QUERY_RENAMED);
+    stmt->set_uint64("dat_no", dat_no);
+    stmt->set_string("original_name", original_name);
+
+    if (!stmt->step()) {
+        return {};
+    }
+
+    return stmt->get_string("name");
+}
+
+
+bool StagingDB::is_fixed(const Game& game) {
+    auto stmt = get_statement(QUERY_FIXED);
+    stmt->set_uint64("game_id", game.id);
+
+    return stmt->step() && stmt->get_bool("fixed");
+}
+
+
+void StagingDB::set_fixed(const Game& game) {
+    auto stmt = get_statement(UPDATE_FIXED);
+    stmt->set_uint64("game_id", game.id);
+    stmt->execute();
+}
+
+
+void StagingDB::set_name(const Game& game) {
+    auto stmt = get_statement(UPDATE_NAME);
+    stmt->set_string("name", game.name, true);
+    stmt->set_uint64("game_id", game.id);
+    stmt->execute();
+}
+
+
+void StagingDB::update_game(const Game& game) {
+    auto stmt = get_statement(UPDATE_GAME);
+    stmt->set_string("parent", game.cloneof[0]);
+    stmt->set_string("grandparent", game.cloneof[1]);
+    stmt->set_uint64("game_id", game.id);
+    stmt->execute();
+
+    stmt = get_statement(UPDATE_FILE);
+    for (size_t ft = 0; ft < TYPE_MAX; ft++) {
+        for (size_t i = 0; i < game.files[ft].size(); i++) {
+            const auto& rom = game.files[ft][i];
+
+            stmt->set_int("location", rom.where);
+            stmt->set_bool("missing", rom.mia);
+            stmt->set_uint64("game_id", game.id);
+            stmt->set_int("file_type", static_cast<int>(ft));
+            stmt->set_int("file_idx", static_cast<int>(i));
+
+            stmt->execute();
+            stmt->reset();
+        }
+    }
+}
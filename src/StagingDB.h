@@ -0,0 +1,116 @@
+#ifndef HAD_STAGING_DB_H
+#define HAD_STAGING_DB_H
+
+/*
+  StagingDB.h -- temporary database of games while writing output
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <functional>
+#include <optional>
+
+#include "DB.h"
+#include "Game.h"
+
+/**
+ * Temporary database holding the games added to an `OutputContext`, so they don't have to be kept in memory.
+ *
+ * Games are identified by their `id`, which is set when they are inserted.
+ */
+class StagingDB : public DB {
+  public:
+    enum Statement {
+        DELETE_FILES_BY_NAME,
+        DELETE_GAMES_BY_NAME,
+        INSERT_FILE,
+        INSERT_GAME,
+        LIST_DUPLICATE_NAMES,
+        LIST_GAMES_BY_NAME,
+        LIST_GAMES_BY_NAME_FINGERPRINT,
+        LIST_GAMES_SORTED,
+        QUERY_FILES,
+        QUERY_FIXED,
+        QUERY_GAME,
+        QUERY_GAME_BY_NAME,
+        QUERY_NEXT_UNFIXED,
+        QUERY_RENAMED,
+        UPDATE_FILE,
+        UPDATE_FIXED,
+        UPDATE_GAME,
+        UPDATE_NAME
+    };
+
+    explicit StagingDB(const std::filesystem::path& file_name);
+    ~StagingDB() override = default;
+
+    /// Add game with its `Game::fingerprint`, setting its `id`.
+    void insert_game(Game* game, uint64_t fingerprint);
+    /// Remove all games named `name`.
+    void delete_games(const std::string& name);
+
+    /// Get the most recently added game named `name`, or null if there is none.
+    [[nodiscard]] GamePtr read_game(const std::string& name);
+    /// Get all games named `name`, in the order they were added.
+    [[nodiscard]] std::vector<GamePtr> read_games(const std::string& name);
+    /// Get all games named `name` with fingerprint `fingerprint`, in the order they were added.
+    [[nodiscard]] std::vector<GamePtr> read_games(const std::string& name, uint64_t fingerprint);
+    /// Get the first game added after the game with id `id` that is not marked as fixed, or null if there is none.
+    [[nodiscard]] GamePtr read_next_unfixed_game(uint64_t id);
+    /**
+     * Call `function` for each game, sorted by name. For games with the same name, only the one added last is used.
+     */
+    void for_each_game_sorted(const std::function<void(GamePtr)>& function);
+
+    /// Get names shared by more than one game.
+    [[nodiscard]] std::vector<std::string> duplicate_names();
+    /// Get the name of the game from dat `dat_no` originally named `original_name`, if it was renamed.
+    [[nodiscard]] std::optional<std::string> renamed_game(size_t dat_no, const std::string& original_name);
+
+    [[nodiscard]] bool is_fixed(const Game& game);
+    void set_fixed(const Game& game);
+    void set_name(const Game& game);
+    /// Store `cloneof` and locations of files of `game`, its other fields must be unchanged.
+    void update_game(const Game& game);
+
+  protected:
+    [[nodiscard]] std::string get_query(int name, bool parameterized) const override;
+
+  private:
+    static const DBFormat format;
+    static std::unordered_map<Statement, std::string> queries;
+
+    DBStatement* get_statement(Statement name) { return get_statement_internal(name); }
+
+    GamePtr read_game(uint64_t id);
+    std::vector<GamePtr> read_games(DBStatement* stmt);
+};
+
+#endif // HAD_STAGING_DB_H
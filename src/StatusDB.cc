@@ -37,7 +37,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 std::shared_ptr<StatusDB> status_db;
 
 const DB::DBFormat StatusDB::format = {0x3,
-                                       1,
+                                       6,
                                        "\
 create table run (\n\
     run_id integer primary key autoincrement,\n\
@@ -53,40 +53,74 @@ create table game (\n\
     dat_id integer not null,\n\
     name text not null,\n\
     checksum binary not null,\n\
-    status integer not null\n\
-);",
-                                       {}};
+    status integer not null,\n\
+    inputs binary,\n\
+    last_run_id integer not null,\n\
+    verdict binary\n\
+);\n\
+create index game_run on game (last_run_id, run_id);\n\
+create index game_checksum on game (checksum, last_run_id, run_id);",
+                                       {{MigrationVersions(1, 2), "alter table game add column inputs binary;"},
+                                        {MigrationVersions(2, 3), "alter table game add column last_run_id integer not "
+                                                                  "null default 0;\n"
+                                                                  "update game set last_run_id = run_id;\n"
+                                                                  "create index game_run on game (last_run_id, "
+                                                                  "run_id);"},
+                                        {MigrationVersions(3, 4), "create index game_checksum on game (checksum);"},
+                                        {MigrationVersions(4, 5), "alter table game add column verdict binary;"},
+                                        {MigrationVersions(5, 6), "drop index game_checksum;\n"
+                                                                  "create index game_checksum on game (checksum, "
+                                                                  "last_run_id, run_id);"}},
+                                       {true, 8 * 1024, 0}};
 
 std::unordered_map<int, std::string> StatusDB::queries = {
     {CLEANUP_DAT, "delete from dat where dat_id not in (select distinct(dat_id) from game)"},
-    {CLEANUP_GAME, "delete from game where run_id not in (select run_id from run)"},
+    {CLEANUP_GAME, "delete from game where not exists (select run_id from run where run.run_id between game.run_id and "
+                   "game.last_run_id)"},
     {DELETE_RUN, "delete from run where run_id = :run_id"},
     {DELETE_RUN_BOTH, "delete from run where date < :date and run_id not in (select run_id from run order by date "
-                      "desc limit :count)"},
-    {DELETE_RUN_COUNT, "delete from run where run_id not in (select run_id from run order by date desc limit :count)"},
+                      "desc, run_id desc limit :count)"},
+    {DELETE_RUN_COUNT,
+     "delete from run where run_id not in (select run_id from run order by date desc, run_id desc limit :count)"},
     {DELETE_RUN_DATE, "delete from run where date < :date"},
     {FIND_DAT, "select dat_id from dat where name = :name and version = :version"},
     {INSERT_DAT, "insert into dat (name, version) values (:name, :version)"},
-    {INSERT_GAME,
-     "insert into game (run_id, dat_id, name, checksum, status) values (:run_id, :dat_id, :name, :checksum, :status)"},
+    {EXTEND_GAME, "update game set last_run_id = :run_id where rowid = :game_id"},
+    {INSERT_GAME, "insert into game (run_id, dat_id, name, checksum, status, inputs, last_run_id, verdict) values "
+                  "(:run_id, :dat_id, :name, :checksum, :status, :inputs, :run_id, :verdict)"},
     {INSERT_RUN, "insert into run (date) values (:date)"},
-    {LATEST_RUN_ID, "select run_id from run order by date desc limit 2"},
+    {LATEST_RUN_ID, "select run_id from run order by date desc, run_id desc limit 2"},
     {LIST_RUNS, "select run_id, date from run order by date asc"},
-    {QUERY_GAME, "select dat_id, name, checksum, status from game where run_id = :run_id"},
-    {QUERY_GAME_BY_STATUS1, "select name from game where run_id = :run_id and status = :status order by name"},
-    {QUERY_GAME_BY_STATUS2,
-     "select name from game where run_id = :run_id and status in (:status1, :status2) order by name"},
-    {QUERY_GAME_BY_STATUS3,
-     "select name from game where run_id = :run_id and status in (:status1, :status2, :status3) order by name"},
-    {QUERY_GAME_BY_STATUS4, "select name from game where run_id = :run_id and status in (:status1, :status2, :status3, "
-                            ":status4) order by name"},
-    {QUERY_GAME_BY_STATUS5, "select name from game where run_id = :run_id and status in (:status1, :status2, :status3, "
-                            ":status4, :status5) order by name"},
-    {QUERY_GAME_BY_STATUS6, "select name from game where run_id = :run_id and status in (:status1, :status2, :status3, "
-                            ":status4, :status5, :status6) order by name"},
-    {QUERY_GAME_STATUS, "select name, status from game where run_id = :run order by name"},
-    {QUERY_RUN_STATUS_COUNTS,
-     "select status, count(*) as status_count from game where run_id = :run_id group by status"},
+    // Games complete in one run for which no game with the same checksum is complete in the other.
+    {QUERY_CHANGES,
+     "select name, 1 as added from game as new where new.run_id <= :run_to and new.last_run_id >= :run_to and "
+     "new.status in (:correct, :correct_mia) and not exists (select 1 from game as old where old.checksum = "
+     "new.checksum and old.run_id <= :run_from and old.last_run_id >= :run_from and old.status in (:correct, "
+     ":correct_mia)) "
+     "union all "
+     "select name, 0 as added from game as old where old.run_id <= :run_from and old.last_run_id >= :run_from and "
+     "old.status in (:correct, :correct_mia) and not exists (select 1 from game as new where new.checksum = "
+     "old.checksum and new.run_id <= :run_to and new.last_run_id >= :run_to and new.status in (:correct, "
+     ":correct_mia)) "
+     "order by name collate nocase"},
+    {QUERY_GAME, "select rowid as game_id, dat_id, name, checksum, status, inputs, last_run_id, verdict from game "
+                 "where run_id <= :run_id and last_run_id >= :run_id"},
+    {QUERY_GAME_BY_STATUS1,
+     "select name from game where run_id <= :run_id and last_run_id >= :run_id and status = :status order by name"},
+    {QUERY_GAME_BY_STATUS2, "select name from game where run_id <= :run_id and last_run_id >= :run_id and status in "
+                            "(:status1, :status2) order by name"},
+    {QUERY_GAME_BY_STATUS3, "select name from game where run_id <= :run_id and last_run_id >= :run_id and status in "
+                            "(:status1, :status2, :status3) order by name"},
+    {QUERY_GAME_BY_STATUS4, "select name from game where run_id <= :run_id and last_run_id >= :run_id and status in "
+                            "(:status1, :status2, :status3, :status4) order by name"},
+    {QUERY_GAME_BY_STATUS5, "select name from game where run_id <= :run_id and last_run_id >= :run_id and status in "
+                            "(:status1, :status2, :status3, :status4, :status5) order by name"},
+    {QUERY_GAME_BY_STATUS6, "select name from game where run_id <= :run_id and last_run_id >= :run_id and status in "
+                            "(:status1, :status2, :status3, :status4, :status5, :status6) order by name"},
+    {QUERY_GAME_STATUS,
+     "select name, status from game where run_id <= :run_id and last_run_id >= :run_id order by name"},
+    {QUERY_RUN_STATUS_COUNTS, "select status, count(*) as status_count from game where run_id <= :run_id and "
+                              "last_run_id >= :run_id group by status"},
 };
 
 std::string StatusDB::get_query(int name, bool parameterized) const {
@@ -148,6 +182,20 @@ void StatusDB::delete_runs_execute(DBStatement* stmt) {
     stmt->execute();
 }
 
+void StatusDB::get_changes(int64_t run_from, int64_t run_to,
+                           const std::function<void(const std::string& name, bool added)>& function) {
+    auto stmt = get_statement(QUERY_CHANGES);
+
+    stmt->set_int64("run_from", run_from);
+    stmt->set_int64("run_to", run_to);
+    stmt->set_int("correct", GS_CORRECT);
+    stmt->set_int("correct_mia", GS_CORRECT_MIA);
+
+    while (stmt->step()) {
+        function(stmt->get_string("name"), stmt->get_int("added") != 0);
+    }
+}
+
 std::vector<StatusDB::GameInfo> StatusDB::get_games(int64_t run_id) {
     auto stmt = get_statement(QUERY_GAME);
 
@@ -158,10 +206,14 @@ std::vector<StatusDB::GameInfo> StatusDB::get_games(int64_t run_id) {
     while (stmt->step()) {
         GameInfo game;
 
+        game.game_id = stmt->get_int64("game_id");
+        game.last_run_id = stmt->get_int64("last_run_id");
         game.dat_id = stmt->get_int("dat_id");
         game.name = stmt->get_string("name");
         game.checksum = stmt->get_blob("checksum");
         game.status = static_cast<GameStatus>(stmt->get_int("status"));
+        game.inputs = stmt->get_blob("inputs");
+        game.verdict = stmt->get_blob("verdict");
 
         games.push_back(game);
     }
@@ -292,9 +344,9 @@ int64_t StatusDB::insert_dat(const DatEntry& dat) {
 }
 
 
-void StatusDB::insert_game(int64_t run_id, const Game& game, int64_t dat_id, GameStatus status) {
-    auto stmt = get_statement(INSERT_GAME);
-
+void StatusDB::insert_game(int64_t run_id, const Game& game, int64_t dat_id, GameStatus status,
+                           const std::vector<uint8_t>& inputs, const std::vector<uint8_t>& verdict,
+                           const GameInfo* previous) {
     if (status == GS_FIXABLE) {
         if (game.is_mia()) {
             status = GS_CORRECT_MIA;
@@ -308,11 +360,36 @@ void StatusDB::insert_game(int64_t run_id, const Game& game, int64_t dat_id, Gam
 
     compute_combined_checksum(game, checksum);
 
+    if (previous && previous->dat_id == dat_id && previous->checksum == checksum && previous->status == status &&
+        previous->inputs == inputs && previous->verdict == verdict) {
+        auto stmt = get_statement(EXTEND_GAME);
+
+        stmt->set_int64("run_id", run_id);
+        stmt->set_int64("game_id", previous->game_id);
+
+        stmt->execute();
+        return;
+    }
+
+    auto stmt = get_statement(INSERT_GAME);
+
     stmt->set_int64("run_id", run_id);
     stmt->set_uint64("dat_id", dat_id);
     stmt->set_string("name", game.name);
     stmt->set_blob("checksum", checksum);
     stmt->set_int("status", static_cast<int>(status));
+    if (inputs.empty()) {
+        stmt->set_null("inputs");
+    }
+    else {
+        stmt->set_blob("inputs", inputs);
+    }
+    if (verdict.empty()) {
+        stmt->set_null("verdict");
+    }
+    else {
+        stmt->set_blob("verdict", verdict);
+    }
 
     stmt->execute();
 }
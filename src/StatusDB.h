@@ -34,6 +34,8 @@
   IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <functional>
+
 #include "DB.h"
 #include "DatEntry.h"
 #include "Game.h"
@@ -48,12 +50,14 @@ class StatusDB : public DB {
         DELETE_RUN_BOTH,
         DELETE_RUN_COUNT,
         DELETE_RUN_DATE,
+        EXTEND_GAME,
         FIND_DAT,
         INSERT_DAT,
         INSERT_GAME,
         INSERT_RUN,
         LIST_RUNS,
         LATEST_RUN_ID,
+        QUERY_CHANGES,
         QUERY_GAME,
         QUERY_GAME_BY_STATUS1,
         QUERY_GAME_BY_STATUS2,
@@ -73,10 +77,17 @@ class StatusDB : public DB {
 
     class GameInfo {
       public:
+        int64_t game_id{};
+        /// Last run this row is valid for; rows unchanged between runs are shared.
+        int64_t last_run_id{};
         int64_t dat_id{};
         std::string name;
         std::vector<uint8_t> checksum;
         GameStatus status;
+        /// Fingerprint of the inputs the status was computed from, empty if not recorded.
+        std::vector<uint8_t> inputs;
+        /// Match quality of each file of the game, empty if the result can't be restored without checking.
+        std::vector<uint8_t> verdict;
     };
 
     static std::string default_name() { return ".ckmame-status.db"; }
@@ -90,13 +101,29 @@ class StatusDB : public DB {
     void delete_run(int64_t run_id);
     void delete_runs(std::optional<int> keep_days, std::optional<int> keep_runs);
     [[nodiscard]] std::vector<Run> list_runs();
+    /**
+     * Report games that became complete or stopped being complete between two runs, ordered by name.
+     *
+     * Games are matched by checksum, so renamed games are not reported. Results are passed to `function` as they are
+     * read from the database.
+     */
+    void get_changes(int64_t run_from, int64_t run_to,
+                     const std::function<void(const std::string& name, bool added)>& function);
     [[nodiscard]] std::vector<GameInfo> get_games(int64_t run_id);
     [[nodiscard]] std::vector<std::string> get_games_by_status(int64_t run_id,
                                                                const std::unordered_set<GameStatus>& status);
     [[nodiscard]] std::unordered_map<GameStatus, std::vector<std::string>> get_run_status_names(int64_t run_id);
     [[nodiscard]] std::unordered_map<GameStatus, uint64_t> get_run_status_counts(int64_t run_id);
     [[nodiscard]] int64_t find_dat(const DatEntry& dat);
-    void insert_game(int64_t run_id, const Game& game, int64_t dat_id, GameStatus status);
+    /**
+     * Record status of game in run.
+     *
+     * @param previous Row of game valid for the previous run, or null. If the game's status and checksum are unchanged,
+     * this row is extended to cover `run_id` instead of inserting a new one.
+     */
+    void insert_game(int64_t run_id, const Game& game, int64_t dat_id, GameStatus status,
+                     const std::vector<uint8_t>& inputs = {}, const std::vector<uint8_t>& verdict = {},
+                     const GameInfo* previous = nullptr);
     [[nodiscard]] int64_t insert_run(time_t date);
     [[nodiscard]] int64_t insert_dat(const DatEntry& dat);
 
@@ -31,16 +31,176 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "StatusDBRun.h"
 
-StatusDBRun::StatusDBRun(std::shared_ptr<StatusDB> db_, RomDB* romdb) : db(std::move(db_)), romdb(romdb) {
+#include <filesystem>
+
+#include "CkmameDB.h"
+#include "Dir.h"
+#include "check_util.h"
+#include "globals.h"
+#include "util.h"
+
+namespace {
+// Stored as first byte of verdicts, change when the encoding of `Match::Quality` changes.
+constexpr uint8_t VERDICT_VERSION = 1;
+
+void add_number(std::string& inputs, uint64_t value) {
+    for (auto shift = 0; shift < 64; shift += 8) {
+        inputs += static_cast<char>((value >> shift) & 0xff);
+    }
+}
+
+void add_string(std::string& inputs, const std::string& value) {
+    add_number(inputs, value.size());
+    inputs += value;
+}
+
+std::vector<uint8_t> digest(const std::string& inputs) {
+    auto hashes = Hashes();
+    hashes.add_types(Hashes::TYPE_SHA1);
+    auto update = Hashes::Update(&hashes);
+    update.update(inputs.data(), inputs.size());
+    update.end();
+
+    return hashes.get_best();
+}
+
+bool is_ignored(const std::filesystem::directory_entry& entry) {
+    auto filename = entry.path().filename().string();
+
+    // Our own databases change on every run.
+    return name_type(entry) == NAME_IGNORE || filename.starts_with(CkmameDB::db_name) ||
+           filename.starts_with(StatusDB::default_name());
+}
+
+void add_entry(std::string& inputs, const std::string& name, const std::filesystem::directory_entry& entry) {
+    std::error_code ec;
+
+    add_string(inputs, name);
+    add_number(inputs, entry.file_size(ec));
+    add_number(inputs, static_cast<uint64_t>(entry.last_write_time(ec).time_since_epoch().count()));
+}
+
+// Add name, size, and modification time of file, or of all files in directory.
+void add_file(std::string& inputs, const std::string& name) {
+    std::error_code ec;
+    auto entry = std::filesystem::directory_entry(name, ec);
+
+    add_string(inputs, name);
+
+    if (ec || !entry.exists(ec)) {
+        add_number(inputs, 0);
+        return;
+    }
+
+    if (!entry.is_directory(ec)) {
+        add_number(inputs, 1);
+        add_entry(inputs, name, entry);
+        return;
+    }
+
+    add_number(inputs, 2);
+    try {
+        Dir dir(name, true);
+
+        for (const auto& dir_entry : dir) {
+            if (!dir_entry.is_regular_file(ec) || is_ignored(dir_entry)) {
+                continue;
+            }
+            add_entry(inputs, dir_entry.path().string(), dir_entry);
+        }
+    }
+    catch (const std::filesystem::filesystem_error&) {
+        // Unreadable directory: record as changed, the check will report the error.
+        add_number(inputs, 3);
+        add_number(inputs, static_cast<uint64_t>(time(nullptr)));
+    }
+}
+} // namespace
+
+
+StatusDBRun::StatusDBRun(std::shared_ptr<StatusDB> db_, RomDB* romdb, bool incremental, bool delta)
+    : db(std::move(db_)), romdb(romdb), incremental(incremental), delta(delta) {
+    db->begin_transaction();
+
+    if (incremental || delta) {
+        previous_run_id = db->latest_run_id();
+        if (previous_run_id) {
+            for (auto& game : db->get_games(*previous_run_id)) {
+                auto name = game.name;
+                previous_games[name] = std::move(game);
+            }
+        }
+    }
+
+    if (incremental) {
+        // Files that games not complete in the last run could use, as of the start of this run.
+        std::string inputs;
+        add_file(inputs, configuration.rom_directory);
+        add_file(inputs, configuration.saved_directory);
+        for (const auto& directory : configuration.extra_directories) {
+            add_file(inputs, directory);
+        }
+        shared_inputs = digest(inputs);
+        shared_inputs_valid = true;
+    }
+
     run_id = db->insert_run(time(nullptr));
     dats = romdb->read_dat();
 }
 
-void StatusDBRun::insert_game_status(const Game& game, const GameStatus& game_status) {
+void StatusDBRun::insert_game_status(const Game& game, const Result& result) {
     if (!db) {
         return;
     }
-    db->insert_game(run_id, game, get_dat_id(game.dat_no), game_status);
+    auto inputs = incremental ? compute_inputs(game, is_complete(result.game)) : std::vector<uint8_t>();
+    auto verdict = incremental ? encode_verdict(game, result) : std::vector<uint8_t>();
+
+    const StatusDB::GameInfo* previous = nullptr;
+    if (delta) {
+        auto it = previous_games.find(game.name);
+        // Only rows that end at the previous run can be extended without covering runs they weren't valid for.
+        if (it != previous_games.end() && it->second.last_run_id == *previous_run_id) {
+            previous = &it->second;
+        }
+    }
+
+    db->insert_game(run_id, game, get_dat_id(game.dat_no), result.game, inputs, verdict, previous);
+}
+
+void StatusDBRun::finish() {
+    if (!db) {
+        return;
+    }
+    db->commit_transaction();
+    db = nullptr;
+}
+
+std::optional<Result> StatusDBRun::unchanged_game_result(const Game& game) {
+    if (!db || !incremental) {
+        return {};
+    }
+
+    auto it = previous_games.find(game.name);
+    if (it == previous_games.end() || it->second.inputs.empty() || it->second.verdict.empty()) {
+        return {};
+    }
+    const auto& previous = it->second;
+
+    auto complete = is_complete(previous.status);
+    if ((!complete && !shared_inputs_valid) || previous.dat_id != get_dat_id(game.dat_no)) {
+        return {};
+    }
+    if (previous.inputs != compute_inputs(game, complete)) {
+        return {};
+    }
+
+    auto result = Result(&game, GameArchives());
+    if (!decode_verdict(game, previous.verdict, &result)) {
+        return {};
+    }
+    result.game = previous.status;
+
+    return result;
 }
 
 int64_t StatusDBRun::get_dat_id(size_t dat_no) {
@@ -57,3 +217,108 @@ int64_t StatusDBRun::get_dat_id(size_t dat_no) {
     dat_ids[dat_no] = id;
     return id;
 }
+
+std::vector<uint8_t> StatusDBRun::compute_inputs(const Game& game, bool complete) const {
+    std::string inputs;
+
+    add_string(inputs, game.name);
+    add_string(inputs, game.cloneof[0]);
+    add_string(inputs, game.cloneof[1]);
+    for (int type = TYPE_ROM; type < TYPE_MAX; type += 1) {
+        add_number(inputs, game.files[type].size());
+        for (const auto& file : game.files[type]) {
+            add_string(inputs, file.name);
+            add_string(inputs, file.merge);
+            add_number(inputs, file.hashes.size);
+            for (auto hash_type = 1; hash_type <= Hashes::TYPE_MAX; hash_type <<= 1) {
+                add_string(inputs, file.hashes.to_string(hash_type));
+            }
+            add_number(inputs, file.status);
+            add_number(inputs, file.where);
+            add_number(inputs, file.mia);
+        }
+    }
+
+    auto detector = romdb->get_detector(romdb->get_detector_id_for_dat(game.dat_no));
+    add_string(inputs, detector ? detector->name : "");
+    add_string(inputs, detector ? detector->version : "");
+
+    add_number(inputs, configuration.roms_zipped);
+    add_number(inputs, configuration.complete_games_only);
+    for (const auto& name : {game.name, game.cloneof[0], game.cloneof[1]}) {
+        if (name.empty()) {
+            continue;
+        }
+        for (auto filetype : romdb->filetypes()) {
+            add_file(inputs, make_file_name(filetype, name));
+        }
+    }
+    if (!configuration.old_db.empty()) {
+        add_file(inputs, configuration.old_db);
+    }
+
+    if (!complete) {
+        inputs.append(shared_inputs.begin(), shared_inputs.end());
+    }
+
+    return digest(inputs);
+}
+
+bool StatusDBRun::is_complete(GameStatus status) {
+    return status == GS_CORRECT || status == GS_CORRECT_MIA || status == GS_OLD || status == GS_FIXABLE;
+}
+
+std::vector<uint8_t> StatusDBRun::encode_verdict(const Game& game, const Result& result) {
+    std::vector<uint8_t> verdict;
+
+    verdict.push_back(VERDICT_VERSION);
+
+    for (int type = TYPE_ROM; type < TYPE_MAX; type += 1) {
+        if (result.game_files[type].size() != game.files[type].size()) {
+            return {};
+        }
+        for (const auto& match : result.game_files[type]) {
+            switch (match.quality) {
+            case Match::MISSING:
+            case Match::UNCHECKED:
+            case Match::NO_HASH:
+            case Match::OK:
+                verdict.push_back(static_cast<uint8_t>(match.quality));
+                break;
+
+            default:
+                // Reporting needs the archive or old ROM database, and the game might be fixed.
+                return {};
+            }
+        }
+
+        for (auto status : result.archive_files[type]) {
+            if (status != FS_USED) {
+                // Other files are reported and might be moved when fixing.
+                return {};
+            }
+        }
+    }
+
+    return verdict;
+}
+
+bool StatusDBRun::decode_verdict(const Game& game, const std::vector<uint8_t>& verdict, Result* result) {
+    size_t count = 1;
+    for (int type = TYPE_ROM; type < TYPE_MAX; type += 1) {
+        count += game.files[type].size();
+    }
+    if (verdict.size() != count || verdict[0] != VERDICT_VERSION) {
+        return false;
+    }
+
+    auto it = verdict.begin() + 1;
+    for (int type = TYPE_ROM; type < TYPE_MAX; type += 1) {
+        for (auto& match : result->game_files[type]) {
+            match.quality = static_cast<Match::Quality>(*it);
+            ++it;
+        }
+    }
+
+    return true;
+}
@@ -32,24 +32,68 @@ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
 IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "RomDB.h"
 #include "StatusDB.h"
 
 class StatusDBRun {
   public:
     StatusDBRun() = default;
-    StatusDBRun(std::shared_ptr<StatusDB> db, RomDB* romdb);
+    /**
+     * Start a new run. All statuses of the run are written in one transaction, which is committed by `finish()`.
+     *
+     * @param incremental Record inputs of games so the next run can skip unchanged ones.
+     * @param delta Only store games whose status changed since the previous run.
+     */
+    StatusDBRun(std::shared_ptr<StatusDB> db, RomDB* romdb, bool incremental = false, bool delta = false);
+
+    void insert_game_status(const Game& game, const Result& result);
+
+    /// Commit statuses recorded in this run.
+    void finish();
 
-    void insert_game_status(const Game& game, const GameStatus& game_status);
+    /**
+     * Get result of game from previous run if none of its inputs changed since then.
+     *
+     * Inputs are the game's definition in the ROM database and the archives of the game and its ancestors. For games
+     * that were not complete, they also include all files in the ROM, extra, and saved directories.
+     *
+     * Only results that can be reported without looking at the archives are recorded: all files of the game are
+     * correct, missing, or not checked, and the archives contain no other files.
+     *
+     * @param game The game to look up.
+     * @return The result from the previous run, without archives, or no value if the game needs to be checked.
+     */
+    std::optional<Result> unchanged_game_result(const Game& game);
+
+    /// Note that files usable by other games may have changed during this run.
+    void invalidate_shared_inputs() { shared_inputs_valid = false; }
 
   private:
     int64_t get_dat_id(size_t dat_no);
 
+    [[nodiscard]] std::vector<uint8_t> compute_inputs(const Game& game, bool complete) const;
+    static bool is_complete(GameStatus status);
+    static std::vector<uint8_t> encode_verdict(const Game& game, const Result& result);
+    static bool decode_verdict(const Game& game, const std::vector<uint8_t>& verdict, Result* result);
+
     std::shared_ptr<StatusDB> db;
     RomDB* romdb{};
     int64_t run_id{-1};
     std::vector<DatEntry> dats;
     std::unordered_map<size_t, int64_t> dat_ids;
+
+    bool incremental{false};
+    bool delta{false};
+    std::optional<int64_t> previous_run_id;
+    std::unordered_map<std::string, StatusDB::GameInfo> previous_games;
+    /// Digest of the files in the ROM, saved, and extra directories.
+    std::vector<uint8_t> shared_inputs;
+    bool shared_inputs_valid{false};
 };
 
 #endif // STATDBRUN_H
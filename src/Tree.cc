@@ -35,6 +35,7 @@
 
 #include "CkmameCache.h"
 #include "Fixdat.h"
+#include "GameStore.h"
 #include "Progress.h"
 #include "RomDB.h"
 #include "StatusDB.h"
@@ -49,7 +50,7 @@
 Tree check_tree;
 
 bool Tree::add(const std::string& game_name) {
-    GamePtr game = db->read_game(game_name);
+    GamePtr game = game_store.get(game_name);
 
     if (!game) {
         return false;
@@ -59,30 +60,32 @@ bool Tree::add(const std::string& game_name) {
 
     if (!game->cloneof[1].empty()) {
         tree = tree->add_node(game->cloneof[1], false);
+        nodes_by_name[tree->name] = tree;
     }
     if (!game->cloneof[0].empty()) {
         tree = tree->add_node(game->cloneof[0], false);
+        nodes_by_name[tree->name] = tree;
     }
 
-    tree->add_node(game_name, true);
+    tree = tree->add_node(game_name, true);
+    nodes_by_name[tree->name] = tree;
 
     return true;
 }
 
 
 bool Tree::recheck(const std::string& game_name) {
-    if (game_name == name) {
-        checked = false;
-        return check;
+    auto it = nodes_by_name.find(game_name);
+    if (it == nodes_by_name.end()) {
+        return false;
     }
 
-    for (const auto& it : children) {
-        if (it.second->recheck(game_name)) {
-            return true;
-        }
+    auto node = it->second;
+    node->checked = false;
+    if (node->check) {
+        pending_rechecks[node->order] = node;
     }
-
-    return false;
+    return node->check;
 }
 
 
@@ -111,15 +114,110 @@ bool Tree::recheck_games_needing(filetype_t filetype, uint64_t size, const Hashe
 void Tree::traverse() {
     GameArchives archives[] = {GameArchives(), GameArchives(), GameArchives()};
 
+    size_t next_order = 0;
+    nodes_in_order.clear();
+    number_nodes(next_order, nodes_in_order);
+
+    if (configuration.prefetch_games > 0) {
+        prefetcher = std::make_unique<Prefetcher>();
+        for (size_t position = 1; position <= static_cast<size_t>(configuration.prefetch_games); position++) {
+            prefetch_node(position);
+        }
+    }
+
     for (const auto& it : children) {
         it.second->traverse_internal(archives);
     }
+
+    prefetcher = nullptr;
 }
 
-void Tree::traverse_internal(GameArchives* ancestor_archives) {
-    GameArchives archives[] = {GameArchives(), ancestor_archives[0], ancestor_archives[1]};
 
-    Progress::push_message("checking " + name);
+void Tree::traverse_rechecks() {
+    // As in a second traversal of the whole tree, games marked while checking a game later in the tree are not checked
+    // again.
+    size_t next_order = 0;
+    while (true) {
+        auto it = pending_rechecks.lower_bound(next_order);
+        if (it == pending_rechecks.end()) {
+            break;
+        }
+        auto node = it->second;
+        next_order = it->first + 1;
+        pending_rechecks.erase(it);
+
+        if (node->check && !node->checked) {
+            node->traverse_recheck();
+        }
+    }
+    pending_rechecks.clear();
+}
+
+
+void Tree::number_nodes(size_t& next_order, std::vector<Tree*>& nodes) {
+    order = next_order++;
+    nodes.push_back(this);
+    for (const auto& it : children) {
+        it.second->number_nodes(next_order, nodes);
+    }
+}
+
+
+void Tree::prefetch(size_t position) {
+    if (!prefetcher) {
+        return;
+    }
+
+    prefetcher->advance(position);
+    prefetch_node(position + configuration.prefetch_games);
+}
+
+
+void Tree::prefetch_node(size_t position) {
+    if (position >= nodes_in_order.size()) {
+        return;
+    }
+
+    auto node = nodes_in_order[position];
+    if (!node->needs_archives()) {
+        return;
+    }
+
+    // Only the files are read, so games checked using their status from the last run cost little.
+    for (auto filetype : db->filetypes()) {
+        prefetcher->add(make_file_name(filetype, node->name), position);
+    }
+}
+
+
+bool Tree::carry_forward_status() {
+    auto game = game_store.get(name);
+
+    if (!game) {
+        return false;
+    }
+
+    auto result = status_run.unchanged_game_result(*game);
+    if (!result) {
+        return false;
+    }
+
+    warn_set_info(WARN_TYPE_GAME, game->name);
+    diagnostics(game.get(), GameArchives(), *result);
+    warn_unset_info();
+
+    if (result->game == GS_CORRECT || result->game == GS_CORRECT_MIA || result->game == GS_OLD) {
+        ckmame_cache->complete_games.insert(game->name);
+    }
+    Fixdat::write_entry(game.get(), &*result);
+    status_run.insert_game_status(*game, *result);
+
+    return true;
+}
+
+
+GameArchives Tree::open_archives() const {
+    GameArchives archives;
 
     auto flags = check ? ARCHIVE_FL_CREATE : 0;
 
@@ -130,10 +228,36 @@ void Tree::traverse_internal(GameArchives* ancestor_archives) {
             full_name = make_file_name(filetype, name);
         }
         if (!full_name.empty()) {
-            archives[0].archive[filetype] = Archive::open(full_name, filetype, FILE_ROMSET, flags);
+            archives.archive[filetype] = Archive::open(full_name, filetype, FILE_ROMSET, flags);
         }
     }
 
+    return archives;
+}
+
+
+Tree* Tree::root() {
+    auto node = this;
+    while (node->parent != nullptr) {
+        node = node->parent;
+    }
+    return node;
+}
+
+
+void Tree::traverse_internal(GameArchives* ancestor_archives) {
+    Progress::push_message("checking " + name);
+
+    root()->prefetch(order);
+
+    if (check && !checked && carry_forward_status()) {
+        checked = true;
+    }
+
+    // Archives are only needed to check this game or its descendants.
+    GameArchives archives[] = {needs_archives() ? open_archives() : GameArchives(), ancestor_archives[0],
+                               ancestor_archives[1]};
+
     if (check && !checked) {
         process(archives);
     }
@@ -146,11 +270,33 @@ void Tree::traverse_internal(GameArchives* ancestor_archives) {
 }
 
 
+void Tree::traverse_recheck() {
+    Progress::push_message("checking " + name);
+
+    // Open archives of ancestors first, as in a traversal of the whole tree.
+    std::vector<Tree*> nodes;
+    for (auto node = this; node->parent != nullptr; node = node->parent) {
+        nodes.push_back(node);
+    }
+    GameArchives archives[] = {GameArchives(), GameArchives(), GameArchives()};
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        archives[2] = archives[1];
+        archives[1] = archives[0];
+        archives[0] = (*it)->open_archives();
+    }
+
+    process(archives);
+
+    Progress::pop_message();
+}
+
+
 Tree* Tree::add_node(const std::string& game_name, bool do_check) {
     auto it = children.find(game_name);
 
     if (it == children.end()) {
         auto child = std::make_shared<Tree>(game_name, do_check);
+        child->parent = this;
         children[game_name] = child;
         return child.get();
     }
@@ -164,7 +310,7 @@ Tree* Tree::add_node(const std::string& game_name, bool do_check) {
 
 
 void Tree::process(GameArchives* archives) {
-    auto game = db->read_game(name);
+    auto game = game_store.get(name);
 
     if (!game) {
         output.error("db error: {} not found", name);
@@ -187,6 +333,7 @@ void Tree::process(GameArchives* archives) {
         diagnostics(game.get(), archives[0], res);
 
         int ret = 0;
+        auto commits = Archive::modifying_commits;
 
         if (configuration.fix_romset) {
             ret = fix_game(game.get(), archives[0], &res);
@@ -197,8 +344,6 @@ void Tree::process(GameArchives* archives) {
             ckmame_cache->complete_games.insert(game->name);
         }
 
-        status_run.insert_game_status(*game.get(), res.game);
-
         /* TODO: includes too much when rechecking */
         Fixdat::write_entry(game.get(), &res);
 
@@ -206,9 +351,19 @@ void Tree::process(GameArchives* archives) {
             ret |= fix_save_needed_from_unknown(game.get(), archives[0], &res);
         }
 
+        // Recorded after fixing, so the archive state matches the next run.
+        status_run.insert_game_status(*game.get(), res);
+        if (Archive::modifying_commits != commits) {
+            // Files other incomplete games could use may have been added, moved, or removed.
+            status_run.invalidate_shared_inputs();
+        }
+
         if (ret != 1) {
             checked = true;
         }
+        else {
+            root()->pending_rechecks[order] = this;
+        }
         warn_unset_info();
     }
     catch (std::exception& ex) {
@@ -218,4 +373,10 @@ void Tree::process(GameArchives* archives) {
 }
 
 
-void Tree::clear() { children.clear(); }
+void Tree::clear() {
+    prefetcher = nullptr;
+    children.clear();
+    nodes_by_name.clear();
+    pending_rechecks.clear();
+    nodes_in_order.clear();
+}
@@ -38,9 +38,12 @@
 #include <memory>
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "GameArchives.h"
 #include "Hashes.h"
+#include "Prefetcher.h"
 #include "types.h"
 
 class Tree;
@@ -60,16 +63,63 @@ class Tree {
     std::map<std::string, TreePtr> children;
 
     bool add(const std::string& game_name);
+
+    /**
+     * Mark game to be checked again by `traverse_rechecks()`.
+     *
+     * @param game_name The name of the game.
+     * @return `true` if the game is being checked.
+     */
     bool recheck(const std::string& game_name);
     bool recheck_games_needing(filetype_t filetype, uint64_t size, const Hashes* hashes);
     void traverse();
 
+    /**
+     * Check games marked by `recheck()` or not completely fixed by `traverse()` again, in tree order. Only these games
+     * and their ancestors are visited.
+     */
+    void traverse_rechecks();
+
     void clear();
 
   private:
+    /// The parent node, `nullptr` for the root.
+    Tree* parent{nullptr};
+
+    /// Position of the node in traversal order, set by `traverse()`.
+    size_t order{0};
+
+    // Only used in the root node.
+
+    /// All nodes, by game name.
+    std::unordered_map<std::string, Tree*> nodes_by_name;
+
+    /// Nodes to check again, by traversal order.
+    std::map<size_t, Tree*> pending_rechecks;
+
+    /// All nodes, in traversal order, set by `traverse()`.
+    std::vector<Tree*> nodes_in_order;
+
+    /// Reads archives of games ahead of the traversal, if enabled.
+    std::unique_ptr<Prefetcher> prefetcher;
+
     Tree* add_node(const std::string& game_name, bool check);
-    void traverse_internal(GameArchives* ancestor_archives);
+
+    /**
+     * Carry forward status from the previous run if the game's inputs are unchanged.
+     *
+     * @return `true` if the game doesn't need to be checked.
+     */
+    bool carry_forward_status();
+    void number_nodes(size_t& next_order, std::vector<Tree*>& nodes);
+    [[nodiscard]] bool needs_archives() const { return (check && !checked) || !children.empty(); }
+    GameArchives open_archives() const;
+    void prefetch(size_t position);
+    void prefetch_node(size_t position);
     void process(GameArchives* archives);
+    Tree* root();
+    void traverse_internal(GameArchives* ancestor_archives);
+    void traverse_recheck();
 };
 
 extern Tree check_tree;
@@ -35,15 +35,41 @@
 #include "config.h"
 
 #include "XmlProcessor.h"
+
+#include <algorithm>
+
 #include "globals.h"
 
 XmlProcessor::XmlProcessor(LineNumberCallback line_number_callback_,
-                           const std::unordered_map<std::string, Entity>& entities_, void* context_)
+                           const std::unordered_map<std::string, Entity>& entities, void* context_)
     : line_number_callback(line_number_callback_),
-      entities(entities_),
       context(context_),
+      parser_context(nullptr),
+      entity_text(nullptr),
       ok(true),
-      stop_parsing(false) {}
+      stop_parsing(false) {
+    for (const auto& [path, entity] : entities) {
+        auto pattern = Pattern{{}, false, &entity};
+        auto remaining = std::string_view(path);
+        if (remaining.starts_with('/')) {
+            pattern.absolute = true;
+            remaining.remove_prefix(1);
+        }
+        std::vector<std::string_view> names;
+        size_t slash;
+        while ((slash = remaining.find('/')) != std::string_view::npos) {
+            names.push_back(remaining.substr(0, slash));
+            remaining.remove_prefix(slash + 1);
+        }
+        pattern.ancestors.assign(names.rbegin(), names.rend());
+        patterns[remaining].push_back(std::move(pattern));
+    }
+    for (auto& [name, list] : patterns) {
+        std::stable_sort(list.begin(), list.end(), [](const Pattern& a, const Pattern& b) {
+            return a.ancestors.size() > b.ancestors.size();
+        });
+    }
+}
 
 
 #ifndef HAVE_LIBXML2
@@ -55,163 +81,212 @@ int XmlProcessor::parse(ParserSource* parser_source) {
 
 #else
 
-#include <libxml/xmlreader.h>
-
-#include <utility>
+#include <libxml/parser.h>
+#include <libxml/SAX2.h>
 
 XmlProcessor::Attribute::Attribute(XmlProcessor::AttributeCallback callback_, const void* arguments_)
     : cb_attr(callback_), arguments(arguments_) {}
 
 
+void XmlProcessor::init() { xmlInitParser(); }
+
+
 bool XmlProcessor::parse(ParserSource* parser_source) {
-    auto reader_source = ReaderSource(parser_source);
-    auto reader = xmlReaderForIO(read, close, &reader_source, nullptr, nullptr, 0);
-    if (reader == nullptr) {
+    // Default handlers keep the DTD, so entities declared in it are resolved; element content is not kept.
+    xmlSAXHandler handler;
+    xmlSAXVersion(&handler, 2);
+    handler.startElementNs = start_element;
+    handler.endElementNs = end_element;
+    handler.characters = characters;
+    handler.ignorableWhitespace = characters;
+    handler.comment = nullptr;
+    handler.processingInstruction = nullptr;
+
+    // The default handlers need the parser context as user data.
+    auto ctxt = xmlCreatePushParserCtxt(&handler, nullptr, nullptr, 0, nullptr);
+    if (ctxt == nullptr) {
         output.file_error("can't open\n");
-        return -1;
+        return false;
     }
+    ctxt->_private = this;
 
+    parser_context = ctxt;
     ok = true;
     stop_parsing = false;
+    entity_text = nullptr;
+    element_names.clear();
+    element_entities.clear();
+
+    char buffer[64 * 1024];
+    size_t length;
+    do {
+        length = parser_source->read(buffer, sizeof(buffer));
+        xmlParseChunk(ctxt, buffer, static_cast<int>(length), length == 0);
+    } while (length > 0 && !stop_parsing);
+
+    if (!stop_parsing && !ctxt->wellFormed) {
+        output.file_error("XML parse error");
+        ok = false;
+    }
 
-    process_tree(reader);
-
-    xmlFreeTextReader(reader);
+    if (ctxt->myDoc != nullptr) {
+        xmlFreeDoc(ctxt->myDoc);
+    }
+    xmlFreeParserCtxt(ctxt);
+    parser_context = nullptr;
 
     return ok;
 }
 
-void XmlProcessor::process_tree(void* reader_) {
-    auto reader = reinterpret_cast<xmlTextReader*>(reader_);
 
-    const Entity* entity_text = nullptr;
-    std::string path;
+void XmlProcessor::start_element(void* ctx, const xmlChar* name, [[maybe_unused]] const xmlChar* prefix,
+                                 [[maybe_unused]] const xmlChar* uri, [[maybe_unused]] int nb_namespaces,
+                                 [[maybe_unused]] const xmlChar** namespaces, int nb_attributes,
+                                 [[maybe_unused]] int nb_defaulted, const xmlChar** attributes) {
+    auto processor = static_cast<XmlProcessor*>(static_cast<xmlParserCtxt*>(ctx)->_private);
 
-    int ret;
-    while ((ret = xmlTextReaderRead(reader)) == 1) {
-        if (line_number_callback) {
-            line_number_callback(context, static_cast<size_t>(xmlTextReaderGetParserLineNumber(reader)));
+    processor->update_line_number();
+
+    // Text is only passed on up to the first child element.
+    processor->flush_text();
+    if (processor->stop_parsing) {
+        return;
+    }
+
+    auto element_name = std::string_view(reinterpret_cast<const char*>(name));
+    auto entity = processor->find(element_name);
+    processor->element_names.push_back(element_name);
+    processor->element_entities.push_back(entity);
+
+    if (entity == nullptr) {
+        return;
+    }
+
+    if (entity->cb_open) {
+        try {
+            processor->handle_callback_status(entity->cb_open(processor->context, entity->arguments));
+        }
+        catch (std::exception& e) {
+            output.file_error("parse error: {}", e.what());
+            processor->ok = false;
         }
 
-        switch (xmlTextReaderNodeType(reader)) {
-        case XML_READER_TYPE_ELEMENT: {
-            auto name = std::string(reinterpret_cast<const char*>(xmlTextReaderConstName(reader)));
-            path += '/' + name;
-
-            auto entity = find(path);
-            if (entity != nullptr) {
-                if (entity->cb_open) {
-                    try {
-                        handle_callback_status(entity->cb_open(context, entity->arguments));
-                    }
-                    catch (std::exception& e) {
-                        output.file_error("parse error: {}", e.what());
-                        ok = false;
-                    }
-
-                    if (stop_parsing) {
-                        return;
-                    }
-                }
-
-                for (const auto& it : entity->attr) {
-                    auto& attribute = it.second;
-                    auto value = reinterpret_cast<char*>(
-                        xmlTextReaderGetAttribute(reader, reinterpret_cast<const xmlChar*>(it.first.c_str())));
-
-                    if (value != nullptr) {
-                        try {
-                            handle_callback_status(attribute.cb_attr(context, attribute.arguments, value));
-                        }
-                        catch (std::exception& e) {
-                            output.file_error("parse error: {}", e.what());
-                            ok = false;
-                        }
-                        free(value);
-
-                        if (stop_parsing) {
-                            return;
-                        }
-                    }
-                }
-
-                if (entity->cb_text) {
-                    entity_text = entity;
-                }
-            }
+        if (processor->stop_parsing) {
+            return;
+        }
+    }
 
-            if (!xmlTextReaderIsEmptyElement(reader)) {
-                break;
+    for (const auto& [attribute_name, attribute] : entity->attr) {
+        // Each attribute is name, prefix, URI, value start, value end.
+        for (int i = 0; i < nb_attributes; i++) {
+            auto attribute_data = attributes + i * 5;
+            if (attribute_data[1] != nullptr ||
+                attribute_name != reinterpret_cast<const char*>(attribute_data[0])) {
+                continue;
             }
-        }
-            /*
-             Fallthrough for empty elements, as we won't get an
-             extra close.
-             */
-
-        case XML_READER_TYPE_END_ELEMENT: {
-            auto entity = find(path);
-            if (entity != nullptr) {
-                if (entity->cb_close) {
-                    try {
-                        handle_callback_status(entity->cb_close(context, entity->arguments));
-                    }
-                    catch (std::exception& e) {
-                        output.file_error("parse error: {}", e.what());
-                        ok = false;
-                    }
-
-                    if (stop_parsing) {
-                        return;
-                    }
-                }
+            auto value = std::string_view(reinterpret_cast<const char*>(attribute_data[3]),
+                                          static_cast<size_t>(attribute_data[4] - attribute_data[3]));
+            try {
+                processor->handle_callback_status(attribute.cb_attr(processor->context, attribute.arguments, value));
+            }
+            catch (std::exception& e) {
+                output.file_error("parse error: {}", e.what());
+                processor->ok = false;
             }
 
-            path.resize(path.find_last_of('/'));
-            entity_text = nullptr;
-
+            if (processor->stop_parsing) {
+                return;
+            }
             break;
         }
+    }
 
-        case XML_READER_TYPE_TEXT:
-            if (entity_text) {
-                try {
-                    handle_callback_status(entity_text->cb_text(context, entity_text->arguments,
-                                                                (const char*)xmlTextReaderConstValue(reader)));
-                }
-                catch (std::exception& e) {
-                    output.file_error("parse error: {}", e.what());
-                    ok = false;
-                }
-
-                if (stop_parsing) {
-                    return;
-                }
-            }
-            break;
+    if (entity->cb_text) {
+        processor->entity_text = entity;
+        processor->text.clear();
+    }
+}
 
-        default:
-            break;
+
+void XmlProcessor::end_element(void* ctx, [[maybe_unused]] const xmlChar* name,
+                               [[maybe_unused]] const xmlChar* prefix, [[maybe_unused]] const xmlChar* uri) {
+    auto processor = static_cast<XmlProcessor*>(static_cast<xmlParserCtxt*>(ctx)->_private);
+
+    processor->update_line_number();
+
+    processor->flush_text();
+    if (processor->stop_parsing) {
+        return;
+    }
+
+    auto entity = processor->element_entities.back();
+    processor->element_names.pop_back();
+    processor->element_entities.pop_back();
+
+    if (entity != nullptr && entity->cb_close) {
+        try {
+            processor->handle_callback_status(entity->cb_close(processor->context, entity->arguments));
+        }
+        catch (std::exception& e) {
+            output.file_error("parse error: {}", e.what());
+            processor->ok = false;
         }
     }
+}
 
-    if (ret != 0) {
-        output.file_error("XML parse error");
+
+void XmlProcessor::characters(void* ctx, const xmlChar* characters, int length) {
+    auto processor = static_cast<XmlProcessor*>(static_cast<xmlParserCtxt*>(ctx)->_private);
+
+    if (processor->entity_text) {
+        processor->text.append(reinterpret_cast<const char*>(characters), static_cast<size_t>(length));
+    }
+}
+
+
+void XmlProcessor::flush_text() {
+    if (entity_text == nullptr) {
+        return;
+    }
+
+    auto entity = entity_text;
+    entity_text = nullptr;
+
+    // Whitespace only text is not content.
+    if (text.find_first_not_of(" \t\n\r") == std::string::npos) {
+        return;
+    }
+
+    try {
+        handle_callback_status(entity->cb_text(context, entity->arguments, text));
+    }
+    catch (std::exception& e) {
+        output.file_error("parse error: {}", e.what());
         ok = false;
     }
 }
 
 
-const XmlProcessor::Entity* XmlProcessor::find(const std::string& path) const {
-    for (auto& pair : entities) {
-        auto& name = pair.first;
-        if (name == path) {
-            return &pair.second;
-        }
+void XmlProcessor::update_line_number() {
+    if (line_number_callback) {
+        line_number_callback(context, static_cast<size_t>(xmlSAX2GetLineNumber(parser_context)));
+    }
+}
 
-        if (name.length() < path.length() && path[path.length() - name.length() - 1] == '/' &&
-            path.compare(path.length() - name.length(), name.length(), name) == 0) {
-            return &pair.second;
+
+const XmlProcessor::Entity* XmlProcessor::find(std::string_view name) const {
+    auto it = patterns.find(name);
+    if (it == patterns.end()) {
+        return nullptr;
+    }
+
+    for (const auto& pattern : it->second) {
+        auto depth = pattern.ancestors.size();
+        if (depth > element_names.size() || (pattern.absolute && depth != element_names.size())) {
+            continue;
+        }
+        if (std::equal(pattern.ancestors.begin(), pattern.ancestors.end(), element_names.rbegin())) {
+            return pattern.entity;
         }
     }
 
@@ -230,45 +305,9 @@ void XmlProcessor::handle_callback_status(CallbackStatus status) {
 
     case END:
         stop_parsing = true;
+        xmlStopParser(static_cast<xmlParserCtxt*>(parser_context));
         break;
     }
 }
 
-
-int XmlProcessor::close([[maybe_unused]] void* source) { return 0; }
-
-
-int XmlProcessor::read(void* source, char* b, int len) {
-    return static_cast<XmlProcessor::ReaderSource*>(source)->read(b, len);
-}
-
-int XmlProcessor::ReaderSource::read(char* b, int len) {
-    if (position >= buffer_length) {
-        if (eof) {
-            return 0;
-        }
-
-        buffer_length = static_cast<int>(source->read(buffer, sizeof(buffer)));
-        position = 0;
-        if (buffer_length == 0) {
-            eof = true;
-            return 0;
-        }
-    }
-
-    int new_position;
-    auto newline = static_cast<char*>(memchr(buffer + position, '\n', buffer_length - position));
-    if (newline != nullptr) {
-        new_position = static_cast<int>(newline - buffer + 1);
-    }
-    else {
-        new_position = buffer_length;
-    }
-
-    auto read_length = std::min(new_position - position, len);
-    memcpy(b, buffer + position, read_length);
-    position += read_length;
-    return read_length;
-}
-
 #endif /* HAVE_LIBXML2 */
@@ -35,8 +35,10 @@
 */
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "ParserSource.h"
 
@@ -45,9 +47,10 @@ class XmlProcessor {
     enum CallbackStatus { OK, ERROR, END };
 
     typedef void (*LineNumberCallback)(void* context, size_t line_number);
-    typedef CallbackStatus (*AttributeCallback)(void* context, const void* arguments, const std::string& value);
+    // `value` is only valid during the callback.
+    typedef CallbackStatus (*AttributeCallback)(void* context, const void* arguments, std::string_view value);
     typedef CallbackStatus (*TagCallback)(void* context, const void* arguments);
-    typedef CallbackStatus (*TextCallback)(void* context, const void* arguments, const std::string& value);
+    typedef CallbackStatus (*TextCallback)(void* context, const void* arguments, std::string_view value);
 
     class Attribute {
       public:
@@ -75,39 +78,59 @@ class XmlProcessor {
         const void* arguments;
     };
 
+    /**
+     * Create processor for `entities`, keyed by element path. A path starting with `/` must match from the root
+     * element, others match the innermost elements, e.g. `game/description` matches `description` inside `game`.
+     */
     XmlProcessor(LineNumberCallback line_number_callback, const std::unordered_map<std::string, Entity>& entities,
                  void* context);
 
     bool parse(ParserSource* parser_source);
 
+    /**
+     * Initialize the XML library. This must be called on the main thread before parsing on multiple threads.
+     */
+    static void init();
+
   private:
-    class ReaderSource {
+    // Entity path split into element names, matched against the open elements.
+    class Pattern {
       public:
-        explicit ReaderSource(ParserSource* source) : source(source), buffer_length(0), position(0), eof(false) {}
-
-        int read(char* b, int len);
-
-      private:
-        ParserSource* source;
-        char buffer[8192];
-        int buffer_length;
-        int position;
-        bool eof;
+        // Names of required ancestors, innermost first.
+        std::vector<std::string_view> ancestors;
+        bool absolute;
+        const Entity* entity;
     };
 
     LineNumberCallback line_number_callback;
-    const std::unordered_map<std::string, Entity>& entities;
     void* context;
 
+    // Patterns keyed by the name of the element they match, most specific first.
+    std::unordered_map<std::string_view, std::vector<Pattern>> patterns;
+
+    void* parser_context; // to avoid leaking libxml header
+
+    // Names of open elements, owned by the parser's dictionary, and their entities.
+    std::vector<std::string_view> element_names;
+    std::vector<const Entity*> element_entities;
+
+    const Entity* entity_text;
+    std::string text;
+
     bool ok;
     bool stop_parsing;
 
-    static int read(void* source, char* b, int len);
-    static int close([[maybe_unused]] void* source);
-
-    [[nodiscard]] const Entity* find(const std::string& path) const;
+    [[nodiscard]] const Entity* find(std::string_view name) const;
     void handle_callback_status(CallbackStatus status);
-    void process_tree(void* reader); // to avoid leaking libxml header
+    void update_line_number();
+    void flush_text();
+
+    static void characters(void* ctx, const unsigned char* characters, int length);
+    static void end_element(void* ctx, const unsigned char* name, const unsigned char* prefix,
+                            const unsigned char* uri);
+    static void start_element(void* ctx, const unsigned char* name, const unsigned char* prefix,
+                              const unsigned char* uri, int nb_namespaces, const unsigned char** namespaces,
+                              int nb_attributes, int nb_defaulted, const unsigned char** attributes);
 };
 
 
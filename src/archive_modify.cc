@@ -51,6 +51,7 @@ bool Archive::commit() {
         if (!commit_xxx()) {
             return false;
         }
+        modifying_commits += 1;
 
         for (size_t index = 0; index < files.size(); index++) {
             auto& change = changes[index];
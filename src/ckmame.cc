@@ -48,6 +48,7 @@
 #include "Configuration.h"
 #include "Exception.h"
 #include "Fixdat.h"
+#include "GameStore.h"
 #include "ProgramName.h"
 #include "Progress.h"
 #include "RomDB.h"
@@ -78,11 +79,14 @@ std::unordered_set<std::string> ckmame_used_variables = {"complete_games_only",
                                                          "delete_unknown_pattern",
                                                          "extra_directories",
                                                          "fixdat_directory",
+                                                         "incremental_check",
+                                                         "jobs",
                                                          "keep_old_duplicate",
                                                          "missing_list",
                                                          "move_from_extra",
                                                          "no_status_db",
                                                          "old_db",
+                                                         "prefetch_games",
                                                          "report_changes",
                                                          "report_correct",
                                                          "report_correct_mia",
@@ -97,6 +101,7 @@ std::unordered_set<std::string> ckmame_used_variables = {"complete_games_only",
                                                          "roms_zipped",
                                                          "saved_directory",
                                                          "status_db",
+                                                         "status_db_delta",
                                                          "status_db_keep_days",
                                                          "status_db_keep_runs",
                                                          "unknown_directory",
@@ -225,6 +230,22 @@ bool CkMame::execute(const std::vector<std::string>& arguments) {
     }
     std::sort(list.begin(), list.end());
 
+    if (arguments.empty()) {
+        /* most games will be checked, load them all at once */
+        try {
+            Progress::Message message("loading games");
+            game_store.load(db.get());
+        }
+        catch (Exception& e) {
+            output.error("can't load games from database '{}': {}", configuration.rom_db, e.what());
+            return false;
+        }
+        if (Progress::trace) {
+            output.message("loaded {} games with {} files, using {} bytes", game_store.size(),
+                           game_store.file_count(), game_store.memory_usage());
+        }
+    }
+
     if (!game_list.empty()) {
         char b[8192];
 
@@ -289,16 +310,19 @@ bool CkMame::execute(const std::vector<std::string>& arguments) {
 
     if (configuration.fix_romset) {
         ckmame_cache->ensure_extra_maps();
+        // Compute detector hashes up front instead of when a file is first not found.
+        ckmame_cache->precompute_detector_hashes(db->detectors);
     }
 
     if (checking_all_games && configuration.fix_romset && configuration.status_db != "none") {
         ensure_dir(std::filesystem::path(configuration.status_db), true);
         status_db = std::make_shared<StatusDB>(configuration.status_db, DBH_WRITE | DBH_CREATE);
-        status_run = StatusDBRun(status_db, db.get());
+        status_run = StatusDBRun(status_db, db.get(), configuration.incremental_check, configuration.status_db_delta);
     }
 
     check_tree.traverse();
-    check_tree.traverse(); /* handle rechecks */
+    check_tree.traverse_rechecks();
+    status_run.finish();
 
     if (configuration.fix_romset) {
         if (!ckmame_cache->needed_delete_list) {
@@ -403,6 +427,7 @@ bool CkMame::cleanup() {
     db = nullptr;
     old_db = nullptr;
     check_tree.clear();
+    game_store.clear();
     ckmame_cache = nullptr;
     ArchiveContents::clear_cache();
 
@@ -279,56 +279,7 @@ void CkStatus::list_summary() {
 
 
 void CkStatus::print_changes() {
-    auto diffs = RunDiff(get_run_from(), get_run_to());
-
-    diffs.compute();
-}
-
-void CkStatus::RunDiff::compute() {
-    insert_run(false);
-    insert_run(true);
-
-    std::sort(games.begin(), games.end());
-
-    for (const auto& game : games) {
-        auto diff = diffs.at(game.checksum);
-        if (diff.new_info && is_complete(diff.new_info->status)) {
-            if (is_complete(diff.new_info->status)) {
-                if (!diff.old_info || !is_complete(diff.old_info->status)) {
-                    output.message("+ {}", game.name);
-                }
-            }
-        }
-        else if (diff.old_info && is_complete(diff.old_info->status)) {
-            output.message("- {}", game.name);
-        }
-    }
-}
-
-
-void CkStatus::RunDiff::insert_run(bool old) {
-    auto infos = status_db->get_games(old ? run_from : run_to);
-
-    for (const auto& info : infos) {
-        auto it = diffs.find(info.checksum);
-        if (it != diffs.end()) {
-            if (old) {
-                it->second.old_info = info;
-            }
-            else {
-                it->second.new_info = info;
-            }
-        }
-        else {
-            games.push_back({info.name, info.checksum});
-            auto diff = GameDiff{};
-            if (old) {
-                diff.old_info = info;
-            }
-            else {
-                diff.new_info = info;
-            }
-            diffs[info.checksum] = diff;
-        }
-    }
+    status_db->get_changes(get_run_from(), get_run_to(), [](const std::string& name, bool added) {
+        output.message("{} {}", added ? "+" : "-", name);
+    });
 }
@@ -33,9 +33,26 @@
 
 #include "Detector.h"
 
+#include <algorithm>
 #include <cstring>
 
-const uint64_t Detector::MAX_DETECTOR_FILE_SIZE = 128 * 1024 * 1024;
+// The vector versions of operations are compiled for their instruction set and selected at runtime, so they are
+// available without building for a specific CPU.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_X86_VECTOR_OPERATIONS
+#include <immintrin.h>
+#endif
+
+#include "Exception.h"
+#include "Progress.h"
+
+
+// Block size for reading files.
+static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+// Size of chunks operations are applied to before hashing, small enough to stay in the first level cache. Must be a
+// multiple of all operation unit sizes.
+static constexpr size_t OPERATION_CHUNK_SIZE = 4 * 1024;
 
 static const uint8_t bitswap[] = {
     0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0, 0x08, 0x88, 0x48,
@@ -54,132 +71,467 @@ static const uint8_t bitswap[] = {
     0xEF, 0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFF};
 
 
-Hashes Detector::execute(const std::vector<uint8_t>& data) const {
-    for (auto& rule : rules) {
-        auto hashes = rule.execute(data);
-        if (hashes.has_size()) {
-            return hashes;
+Detector::Execution::Execution(uint64_t size_) : size(size_) {}
+
+
+size_t Detector::Execution::add(const Detector& detector) {
+    auto& rules = detectors.emplace_back();
+
+    for (const auto& rule : detector.rules) {
+        auto& execution = rules.emplace_back();
+
+        auto start = rule.start_offset;
+        if (start < 0) {
+            start += static_cast<int64_t>(size);
+        }
+        auto end = rule.end_offset;
+        if (end == DETECTOR_OFFSET_EOF) {
+            end = static_cast<int64_t>(size);
         }
+        else if (end < 0) {
+            end += static_cast<int64_t>(size);
+        }
+
+        if (start < 0 || static_cast<uint64_t>(start) > size || end < 0 || static_cast<uint64_t>(end) > size ||
+            start > end || static_cast<uint64_t>(end - start) % operation_unit_size(rule.operation) != 0) {
+            execution.state = FAILED;
+            continue;
+        }
+
+        for (const auto& test : rule.tests) {
+            auto& test_data = execution.tests.emplace_back();
+            test_data.test = &test;
+            auto offset = test.data_offset(size);
+            if (offset) {
+                test_data.window = add_window(*offset, test.length);
+                test_data.window_offset = *offset - windows[*test_data.window].offset;
+                execution.decided_at = std::max(execution.decided_at, *offset + test.length);
+            }
+        }
+
+        execution.range = add_range(static_cast<uint64_t>(start), static_cast<uint64_t>(end), rule.operation);
     }
 
-    return {};
+    advance(rules);
+
+    return detectors.size() - 1;
 }
 
 
-bool Detector::Test::bit_cmp(const uint8_t* b) const {
-    switch (type) {
-    case TEST_OR:
-        for (size_t i = 0; i < length; i++) {
-            if ((b[i] | mask[i]) != value[i]) {
-                return false;
-            }
+void Detector::Execution::update(const uint8_t* data, size_t length) {
+    auto block_end = position + length;
+
+    for (auto& window : windows) {
+        auto from = std::max(window.offset, position);
+        auto to = std::min(window.offset + window.length, block_end);
+        if (from < to) {
+            window.data.insert(window.data.end(), data + (from - position), data + (to - position));
         }
-        return true;
+    }
 
-    case TEST_AND:
-        for (size_t i = 0; i < length; i++) {
-            if ((b[i] & mask[i]) != value[i]) {
-                return false;
-            }
+    for (auto& range : ranges) {
+        if (!range.hashes_update) {
+            continue;
         }
-        return true;
+        auto from = std::max(range.start, position);
+        auto to = std::min(range.end, block_end);
+        if (from < to) {
+            range.hash(data + (from - position), to - from, buffer);
+        }
+    }
 
-    case TEST_XOR:
-        for (size_t i = 0; i < length; i++) {
-            if ((b[i] ^ mask[i]) != value[i]) {
-                return false;
+    position = block_end;
+
+    for (auto& rules : detectors) {
+        advance(rules);
+    }
+}
+
+
+Hashes Detector::Execution::end(size_t index) {
+    for (auto& execution : detectors[index]) {
+        if (execution.state == UNDECIDED) {
+            decide(execution);
+        }
+        if (execution.state == PASSED) {
+            auto range = execution.range;
+            if (range->hashes_update) {
+                range->hashes_update->end();
+                range->hashes_update = nullptr;
+                range->hashes.size = range->end - range->start;
             }
+            return range->hashes;
         }
-        return true;
+    }
 
-    default:
-        return false;
+    return {};
+}
+
+
+size_t Detector::Execution::add_window(uint64_t offset, uint64_t length) {
+    for (size_t i = 0; i < windows.size(); i++) {
+        if (windows[i].offset <= offset && offset + length <= windows[i].offset + windows[i].length) {
+            return i;
+        }
     }
+
+    auto& window = windows.emplace_back();
+    window.offset = offset;
+    window.length = length;
+    window.data.reserve(length);
+    return windows.size() - 1;
 }
 
 
-Hashes Detector::Rule::compute_values(Operation operation, const std::vector<uint8_t>& data, uint64_t start,
-                                      uint64_t length) const {
-    Hashes hashes;
+Detector::Execution::Range* Detector::Execution::add_range(uint64_t start, uint64_t end, Operation operation) {
+    for (auto& range : ranges) {
+        // Ranges no longer used have stopped hashing.
+        if (range.users > 0 && range.start == start && range.end == end && range.operation == operation) {
+            range.users += 1;
+            return &range;
+        }
+    }
 
-    hashes.add_types(Hashes::TYPE_ALL);
-    Hashes::Update hu(&hashes);
+    auto& range = ranges.emplace_back();
+    range.start = start;
+    range.end = end;
+    range.operation = operation;
+    range.users = 1;
+    range.hashes.add_types(Hashes::TYPE_ALL);
+    range.hashes_update = std::make_unique<Hashes::Update>(&range.hashes);
 
-    if (operation == OP_NONE) {
-        hu.update(data.data() + start, length);
+    if (operation != OP_NONE) {
+        buffer.resize(OPERATION_CHUNK_SIZE);
     }
-    else {
-        auto processed_data = std::vector<uint8_t>(length);
 
-        switch (operation) {
-        case OP_NONE:
-            // can't happen
-            break;
+    return &range;
+}
 
-        case OP_BITSWAP:
-            for (size_t i = 0; i < length; i++) {
-                processed_data[i] = bitswap[data[start + i]];
-            }
-            break;
 
-        case OP_BYTESWAP:
-            for (size_t i = 0; i < length; i += 2) {
-                processed_data[i] = data[start + i + 1];
-                processed_data[i + 1] = data[start + i];
-            }
+// Decide rules whose data is complete, and stop hashing for rules that can no longer be the first match.
+void Detector::Execution::advance(std::vector<RuleExecution>& rules) const {
+    auto matched = false;
+    for (auto& execution : rules) {
+        if (matched) {
+            // An earlier rule matched, this one is not needed.
+            fail(execution);
+            continue;
+        }
+        if (execution.state == UNDECIDED && execution.decided_at <= position) {
+            decide(execution);
+        }
+        if (execution.state == UNDECIDED) {
             break;
+        }
+        if (execution.state == PASSED) {
+            matched = true;
+        }
+    }
+}
 
-        case OP_WORDSWAP:
-            for (size_t i = 0; i < length; i += 4) {
-                processed_data[i] = data[start + i + 3];
-                processed_data[i + 1] = data[start + i + 2];
-                processed_data[i + 2] = data[start + i + 1];
-                processed_data[i + 3] = data[start + i];
-            }
+
+void Detector::Execution::decide(RuleExecution& execution) const {
+    for (const auto& test : execution.tests) {
+        auto data = test.window ? windows[*test.window].data.data() + test.window_offset : nullptr;
+        if (!test.test->execute(data, size)) {
+            fail(execution);
+            return;
         }
+    }
+
+    execution.state = PASSED;
+}
 
-        hu.update(processed_data.data(), length);
+
+void Detector::Execution::fail(RuleExecution& execution) {
+    if (execution.state == FAILED) {
+        return;
     }
+    execution.state = FAILED;
+    execution.range->release();
+}
 
-    hu.end();
 
-    hashes.size = length;
-    return hashes;
+void Detector::Execution::Range::release() {
+    users -= 1;
+    if (users == 0) {
+        hashes_update = nullptr;
+    }
 }
 
 
-Hashes Detector::Rule::execute(const std::vector<uint8_t>& data) const {
-    auto start = start_offset;
-    if (start < 0) {
-        start += static_cast<int64_t>(data.size());
+void Detector::Execution::Range::hash(const uint8_t* data, size_t length, std::vector<uint8_t>& buffer) {
+    if (operation == OP_NONE) {
+        hashes_update->update(data, length);
+        return;
     }
-    auto end = end_offset;
-    if (end == DETECTOR_OFFSET_EOF) {
-        end = static_cast<int64_t>(data.size());
+
+    auto unit = operation_unit_size(operation);
+
+    // Complete unit left over from previous block.
+    if (pending_length > 0) {
+        auto n = std::min(unit - pending_length, length);
+        memcpy(pending + pending_length, data, n);
+        pending_length += n;
+        data += n;
+        length -= n;
+        if (pending_length < unit) {
+            return;
+        }
+        uint8_t processed[sizeof(pending)];
+        apply_operation(operation, pending, processed, unit);
+        hashes_update->update(processed, unit);
+        pending_length = 0;
     }
-    else if (end < 0) {
-        end += static_cast<int64_t>(data.size());
+
+    while (length >= unit) {
+        auto n = std::min(length - length % unit, buffer.size());
+        apply_operation(operation, data, buffer.data(), n);
+        hashes_update->update(buffer.data(), n);
+        data += n;
+        length -= n;
     }
 
-    if (start < 0 || static_cast<uint64_t>(start) > data.size() || end < 0 ||
-        static_cast<uint64_t>(end) > data.size() || start > end ||
-        static_cast<uint64_t>(end - start) % operation_unit_size(operation) != 0) {
-        return {};
+    memcpy(pending, data, length);
+    pending_length = length;
+}
+
+
+namespace {
+uint64_t load64(const uint8_t* data) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+void store64(uint8_t* data, uint64_t value) { memcpy(data, &value, sizeof(value)); }
+
+// These operate on each byte, pair of bytes, or four bytes independently, so they work for either byte order.
+
+uint64_t bitswap64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555) | ((x & 0x5555555555555555) << 1);
+    x = ((x >> 2) & 0x3333333333333333) | ((x & 0x3333333333333333) << 2);
+    return ((x >> 4) & 0x0F0F0F0F0F0F0F0F) | ((x & 0x0F0F0F0F0F0F0F0F) << 4);
+}
+
+uint64_t byteswap64(uint64_t x) { return ((x >> 8) & 0x00FF00FF00FF00FF) | ((x & 0x00FF00FF00FF00FF) << 8); }
+
+uint64_t wordswap64(uint64_t x) {
+    x = byteswap64(x);
+    return ((x >> 16) & 0x0000FFFF0000FFFF) | ((x & 0x0000FFFF0000FFFF) << 16);
+}
+
+#if defined(HAVE_X86_VECTOR_OPERATIONS)
+// Returns number of bytes processed.
+__attribute__((target("avx2"))) size_t apply_operation_avx2(Detector::Operation operation, const uint8_t* data,
+                                                            uint8_t* result, size_t length) {
+    const auto nibble_mask = _mm256_set1_epi8(0x0F);
+    const auto reverse_low = _mm256_setr_epi8(0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0,
+                                              0x30, 0xB0, 0x70, 0xF0, 0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0,
+                                              0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0);
+    const auto reverse_high = _mm256_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7,
+                                               0xF, 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB,
+                                               0x7, 0xF);
+    const auto byteswap_shuffle = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5,
+                                                   4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const auto wordswap_shuffle = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7,
+                                                   6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        switch (operation) {
+        case Detector::OP_BITSWAP:
+            x = _mm256_or_si256(_mm256_shuffle_epi8(reverse_low, _mm256_and_si256(x, nibble_mask)),
+                                _mm256_shuffle_epi8(reverse_high, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble_mask)));
+            break;
+        case Detector::OP_BYTESWAP:
+            x = _mm256_shuffle_epi8(x, byteswap_shuffle);
+            break;
+        case Detector::OP_WORDSWAP:
+            x = _mm256_shuffle_epi8(x, wordswap_shuffle);
+            break;
+        case Detector::OP_NONE:
+            break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), x);
     }
+    return i;
+}
+// Returns number of bytes processed.
+__attribute__((target("ssse3"))) size_t apply_operation_ssse3(Detector::Operation operation, const uint8_t* data,
+                                                              uint8_t* result, size_t length) {
+    const auto nibble_mask = _mm_set1_epi8(0x0F);
+    const auto reverse_low = _mm_setr_epi8(0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0, 0x30,
+                                           0xB0, 0x70, 0xF0);
+    const auto reverse_high = _mm_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7,
+                                            0xF);
+    const auto byteswap_shuffle = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    const auto wordswap_shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        switch (operation) {
+        case Detector::OP_BITSWAP:
+            x = _mm_or_si128(_mm_shuffle_epi8(reverse_low, _mm_and_si128(x, nibble_mask)),
+                             _mm_shuffle_epi8(reverse_high, _mm_and_si128(_mm_srli_epi16(x, 4), nibble_mask)));
+            break;
+        case Detector::OP_BYTESWAP:
+            x = _mm_shuffle_epi8(x, byteswap_shuffle);
+            break;
+        case Detector::OP_WORDSWAP:
+            x = _mm_shuffle_epi8(x, wordswap_shuffle);
+            break;
+        case Detector::OP_NONE:
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), x);
+    }
+    return i;
+}
 
-    for (auto& test : tests) {
-        if (!test.execute(data)) {
-            return {};
+typedef size_t (*VectorOperation)(Detector::Operation operation, const uint8_t* data, uint8_t* result, size_t length);
+
+VectorOperation select_vector_operation() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return apply_operation_avx2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return apply_operation_ssse3;
+    }
+    return nullptr;
+}
+
+// Returns number of bytes processed.
+size_t apply_operation_vector(Detector::Operation operation, const uint8_t* data, uint8_t* result, size_t length) {
+    static const auto vector_operation = select_vector_operation();
+
+    return vector_operation ? vector_operation(operation, data, result, length) : 0;
+}
+#else
+size_t apply_operation_vector(Detector::Operation, const uint8_t*, uint8_t*, size_t) { return 0; }
+#endif
+} // namespace
+
+
+void Detector::apply_operation(Operation operation, const uint8_t* data, uint8_t* result, size_t length) {
+    if (operation == OP_NONE) {
+        memcpy(result, data, length);
+        return;
+    }
+
+    // Use vector instructions if the CPU supports them, then process eight bytes at a time.
+    auto i = apply_operation_vector(operation, data, result, length);
+
+    for (; i + 8 <= length; i += 8) {
+        auto x = load64(data + i);
+        switch (operation) {
+        case OP_BITSWAP:
+            x = bitswap64(x);
+            break;
+        case OP_BYTESWAP:
+            x = byteswap64(x);
+            break;
+        case OP_WORDSWAP:
+            x = wordswap64(x);
+            break;
+        case OP_NONE:
+            break;
         }
+        store64(result + i, x);
     }
 
-    return compute_values(operation, data, static_cast<uint64_t>(start), static_cast<uint64_t>(end - start));
+    // Remaining bytes, length is a multiple of the operation unit size.
+    switch (operation) {
+    case OP_NONE:
+        break;
+
+    case OP_BITSWAP:
+        for (; i < length; i++) {
+            result[i] = bitswap[data[i]];
+        }
+        break;
+
+    case OP_BYTESWAP:
+        for (; i < length; i += 2) {
+            result[i] = data[i + 1];
+            result[i + 1] = data[i];
+        }
+        break;
+
+    case OP_WORDSWAP:
+        for (; i < length; i += 4) {
+            result[i] = data[i + 3];
+            result[i + 1] = data[i + 2];
+            result[i + 2] = data[i + 1];
+            result[i + 3] = data[i];
+        }
+        break;
+    }
 }
 
 
-bool Detector::Test::execute(const std::vector<uint8_t>& data) const {
-    auto match = false;
+bool Detector::Test::bit_cmp(const uint8_t* b) const {
+    // Compare eight bytes at a time, then the rest.
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        auto data = load64(b + i);
+        auto mask64 = load64(mask.data() + i);
+        auto value64 = load64(value.data() + i);
+        uint64_t masked;
+
+        switch (type) {
+        case TEST_OR:
+            masked = data | mask64;
+            break;
+        case TEST_AND:
+            masked = data & mask64;
+            break;
+        case TEST_XOR:
+            masked = data ^ mask64;
+            break;
+        default:
+            return false;
+        }
+        if (masked != value64) {
+            return false;
+        }
+    }
 
+    switch (type) {
+    case TEST_OR:
+        for (; i < length; i++) {
+            if ((b[i] | mask[i]) != value[i]) {
+                return false;
+            }
+        }
+        return true;
+
+    case TEST_AND:
+        for (; i < length; i++) {
+            if ((b[i] & mask[i]) != value[i]) {
+                return false;
+            }
+        }
+        return true;
+
+    case TEST_XOR:
+        for (; i < length; i++) {
+            if ((b[i] ^ mask[i]) != value[i]) {
+                return false;
+            }
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+std::optional<uint64_t> Detector::Test::data_offset(uint64_t size) const {
     switch (type) {
     case TEST_DATA:
     case TEST_OR:
@@ -188,19 +540,40 @@ bool Detector::Test::execute(const std::vector<uint8_t>& data) const {
         auto off = offset;
 
         if (off < 0) {
-            off += data.size();
+            off += static_cast<int64_t>(size);
         }
 
         if (off < 0 || static_cast<uint64_t>(off) + length < static_cast<uint64_t>(off) ||
-            static_cast<uint64_t>(off) + length > data.size()) {
+            static_cast<uint64_t>(off) + length > size) {
+            return {};
+        }
+
+        return static_cast<uint64_t>(off);
+    }
+
+    default:
+        return {};
+    }
+}
+
+
+bool Detector::Test::execute(const uint8_t* data, uint64_t size) const {
+    auto match = false;
+
+    switch (type) {
+    case TEST_DATA:
+    case TEST_OR:
+    case TEST_AND:
+    case TEST_XOR: {
+        if (!data_offset(size)) {
             return false;
         }
 
         if (mask.empty()) {
-            match = (memcmp(data.data() + off, value.data(), length) == 0);
+            match = (memcmp(data, value.data(), length) == 0);
         }
         else {
-            match = bit_cmp(data.data() + off);
+            match = bit_cmp(data);
         }
         break;
     }
@@ -211,14 +584,14 @@ bool Detector::Test::execute(const std::vector<uint8_t>& data) const {
         if (offset == DETECTOR_SIZE_POWER_OF_2) {
             match = false;
             for (auto i = 0; i < 64; i++) {
-                if (data.size() == (static_cast<uint64_t>(1) << i)) {
+                if (size == (static_cast<uint64_t>(1) << i)) {
                     match = true;
                     break;
                 }
             }
         }
         else {
-            int64_t cmp = offset - static_cast<int64_t>(data.size());
+            int64_t cmp = offset - static_cast<int64_t>(size);
 
             switch (type) {
             case TEST_FILE_EQ:
@@ -246,13 +619,17 @@ bool Detector::Test::execute(const std::vector<uint8_t>& data) const {
 }
 
 
-bool Detector::compute_hashes(const std::vector<uint8_t>& data, File* file,
+bool Detector::compute_hashes(const ZipSource* source, File* file,
                               const std::unordered_map<size_t, DetectorPtr>& detectors,
                               std::unordered_set<size_t>* changed) {
-    if (file->get_size(0) > MAX_DETECTOR_FILE_SIZE) {
+    if (!file->is_size_known(0)) {
         return false;
     }
 
+    auto size = file->get_size(0);
+    auto execution = Execution(size);
+    std::vector<std::pair<size_t, size_t>> indices;
+
     for (const auto& [id, detector] : detectors) {
         auto it = file->detector_hashes.find(id);
 
@@ -260,7 +637,28 @@ bool Detector::compute_hashes(const std::vector<uint8_t>& data, File* file,
             continue;
         }
 
-        file->detector_hashes[id] = detector->execute(data);
+        indices.emplace_back(id, execution.add(*detector));
+    }
+
+    if (indices.empty()) {
+        return true;
+    }
+
+    // All detectors are run on a single pass over the data.
+    auto data = std::vector<uint8_t>(std::min(size, static_cast<uint64_t>(BLOCK_SIZE)));
+    auto remaining = size;
+    while (remaining > 0) {
+        auto n = std::min(remaining, static_cast<uint64_t>(data.size()));
+        if (source->read(data.data(), n) != n) {
+            throw Exception("unexpected end of file");
+        }
+        execution.update(data.data(), n);
+        remaining -= n;
+        Progress::update();
+    }
+
+    for (const auto& [id, index] : indices) {
+        file->detector_hashes[id] = execution.end(index);
         if (changed) {
             changed->insert(id);
         }
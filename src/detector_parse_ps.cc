@@ -67,46 +67,46 @@ class DetectorParserContext {
 
     static void line_number_callback(void* context, size_t line_number);
 
-    [[nodiscard]] std::optional<int> parse_enum(const std::string& value,
+    [[nodiscard]] std::optional<int> parse_enum(std::string_view value,
                                                 const std::unordered_map<std::string, int>& enums,
                                                 const std::string& field_name) const;
-    XmlProcessor::CallbackStatus parse_hex(std::vector<uint8_t>* result, const std::string& value,
+    XmlProcessor::CallbackStatus parse_hex(std::vector<uint8_t>* result, std::string_view value,
                                            const std::string& field_name);
-    XmlProcessor::CallbackStatus parse_number(int64_t* result, const std::string& value,
+    XmlProcessor::CallbackStatus parse_number(int64_t* result, std::string_view value,
                                               const std::string& field_name) const;
-    XmlProcessor::CallbackStatus parse_offset(int64_t* result, const std::string& value, const std::string& field_name);
-    XmlProcessor::CallbackStatus parse_size(int64_t* result, const std::string& value, const std::string& field_name);
+    XmlProcessor::CallbackStatus parse_offset(int64_t* result, std::string_view value, const std::string& field_name);
+    XmlProcessor::CallbackStatus parse_size(int64_t* result, std::string_view value, const std::string& field_name);
 
     static XmlProcessor::CallbackStatus rule_close(void* ctx, [[maybe_unused]] const void* args);
     static XmlProcessor::CallbackStatus rule_end_offset(void* ctx, [[maybe_unused]] const void* args,
-                                                        const std::string& value);
+                                                        std::string_view value);
     static XmlProcessor::CallbackStatus rule_open(void* ctx, [[maybe_unused]] const void* args);
     static XmlProcessor::CallbackStatus rule_operation(void* ctx, [[maybe_unused]] const void* args,
-                                                       const std::string& value);
+                                                       std::string_view value);
     static XmlProcessor::CallbackStatus rule_start_offset(void* ctx, [[maybe_unused]] const void* args,
-                                                          const std::string& value);
+                                                          std::string_view value);
 
     static XmlProcessor::CallbackStatus
     test_close(void* ctx, [[maybe_unused]] [[maybe_unused]] [[maybe_unused]] [[maybe_unused]] const void* args);
     static XmlProcessor::CallbackStatus test_mask(void* ctx, [[maybe_unused]] const void* args,
-                                                  const std::string& value);
+                                                  std::string_view value);
     static XmlProcessor::CallbackStatus test_offset(void* ctx, [[maybe_unused]] const void* args,
-                                                    const std::string& value);
+                                                    std::string_view value);
     static XmlProcessor::CallbackStatus test_open(void* ctx, [[maybe_unused]] const void* args);
     static XmlProcessor::CallbackStatus test_operator(void* ctx, [[maybe_unused]] const void* args,
-                                                      const std::string& value);
+                                                      std::string_view value);
     static XmlProcessor::CallbackStatus test_result(void* ctx, [[maybe_unused]] const void* args,
-                                                    const std::string& value);
+                                                    std::string_view value);
     static XmlProcessor::CallbackStatus test_size(void* ctx, [[maybe_unused]] const void* args,
-                                                  const std::string& value);
+                                                  std::string_view value);
     static XmlProcessor::CallbackStatus test_value(void* ctx, [[maybe_unused]] const void* args,
-                                                   const std::string& value);
+                                                   std::string_view value);
     static XmlProcessor::CallbackStatus text_author(void* ctx, [[maybe_unused]] const void* args,
-                                                    const std::string& value);
+                                                    std::string_view value);
     static XmlProcessor::CallbackStatus text_name(void* ctx, [[maybe_unused]] const void* args,
-                                                  const std::string& value);
+                                                  std::string_view value);
     static XmlProcessor::CallbackStatus text_version(void* ctx, [[maybe_unused]] const void* args,
-                                                     const std::string& value);
+                                                     std::string_view value);
 
     static const std::unordered_map<std::string, XmlProcessor::Attribute> attributes_bit;
     static const std::unordered_map<std::string, XmlProcessor::Attribute> attributes_data;
@@ -174,10 +174,10 @@ DetectorPtr Detector::parse(ParserSource* parser_source) {
 }
 
 
-std::optional<int> DetectorParserContext::parse_enum(const std::string& value,
+std::optional<int> DetectorParserContext::parse_enum(std::string_view value,
                                                      const std::unordered_map<std::string, int>& enums,
                                                      const std::string& field_name) const {
-    auto it = enums.find(value);
+    auto it = enums.find(std::string(value));
 
     if (it == enums.end()) {
         output.line_error(lineno, "invalid {}: '{}'", field_name, value);
@@ -189,7 +189,7 @@ std::optional<int> DetectorParserContext::parse_enum(const std::string& value,
 }
 
 
-XmlProcessor::CallbackStatus DetectorParserContext::parse_hex(std::vector<uint8_t>* result, const std::string& value,
+XmlProcessor::CallbackStatus DetectorParserContext::parse_hex(std::vector<uint8_t>* result, std::string_view value,
                                                               const std::string& field_name) {
     if (value.size() % 2 != 0) {
         output.line_error(lineno, "invalid {}: odd number of hex digits", field_name);
@@ -209,7 +209,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::parse_hex(std::vector<uint8_
 }
 
 
-XmlProcessor::CallbackStatus DetectorParserContext::parse_number(int64_t* result, const std::string& value,
+XmlProcessor::CallbackStatus DetectorParserContext::parse_number(int64_t* result, std::string_view value,
                                                                  const std::string& field_name) const {
     int64_t i;
 
@@ -221,7 +221,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::parse_number(int64_t* result
     try {
         size_t end;
 
-        i = std::stoll(value, &end, 16);
+        i = std::stoll(std::string(value), &end, 16);
 
         if (end != value.length()) {
             output.line_error(lineno, "invalid {}: '{}'", field_name, value);
@@ -238,7 +238,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::parse_number(int64_t* result
 }
 
 
-XmlProcessor::CallbackStatus DetectorParserContext::parse_offset(int64_t* result, const std::string& value,
+XmlProcessor::CallbackStatus DetectorParserContext::parse_offset(int64_t* result, std::string_view value,
                                                                  const std::string& field_name) {
     if (value == "EOF") {
         *result = DETECTOR_OFFSET_EOF;
@@ -249,7 +249,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::parse_offset(int64_t* result
 }
 
 
-XmlProcessor::CallbackStatus DetectorParserContext::parse_size(int64_t* result, const std::string& value,
+XmlProcessor::CallbackStatus DetectorParserContext::parse_size(int64_t* result, std::string_view value,
                                                                const std::string& field_name) {
     if (value == "PO2") {
         *result = DETECTOR_SIZE_POWER_OF_2;
@@ -270,7 +270,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::rule_close(void* ctx, [[mayb
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::rule_end_offset(void* ctx, [[maybe_unused]] const void* args,
-                                                                    const std::string& value) {
+                                                                    std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     return context->parse_offset(&context->rule->end_offset, value, "end_offset");
@@ -288,7 +288,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::rule_open(void* ctx, [[maybe
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::rule_operation(void* ctx, [[maybe_unused]] const void* args,
-                                                                   const std::string& value) {
+                                                                   std::string_view value) {
     static const std::unordered_map<std::string, int> op = {{"bitswap", Detector::OP_BITSWAP},
                                                             {"byteswap", Detector::OP_BYTESWAP},
                                                             {"none", Detector::OP_NONE},
@@ -307,7 +307,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::rule_operation(void* ctx, [[
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::rule_start_offset(void* ctx, [[maybe_unused]] const void* args,
-                                                                      const std::string& value) {
+                                                                      std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     return context->parse_offset(&context->rule->start_offset, value, "start_offset");
@@ -325,7 +325,7 @@ DetectorParserContext::test_close(void* ctx, [[maybe_unused]] const void* args)
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::test_mask(void* ctx, [[maybe_unused]] const void* args,
-                                                              const std::string& value) {
+                                                              std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     return context->parse_hex(&context->test->mask, value, "mask");
@@ -333,7 +333,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::test_mask(void* ctx, [[maybe
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::test_offset(void* ctx, [[maybe_unused]] const void* args,
-                                                                const std::string& value) {
+                                                                std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     return context->parse_offset(&context->test->offset, value, "offset");
@@ -351,7 +351,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::test_open(void* ctx, [[maybe
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::test_operator(void* ctx, [[maybe_unused]] const void* args,
-                                                                  const std::string& value) {
+                                                                  std::string_view value) {
     static std::unordered_map<std::string, int> enums = {
         {"equal", Detector::TEST_FILE_EQ}, {"greater", Detector::TEST_FILE_GR}, {"less", Detector::TEST_FILE_LE}};
 
@@ -368,7 +368,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::test_operator(void* ctx, [[m
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::test_result(void* ctx, [[maybe_unused]] const void* args,
-                                                                const std::string& value) {
+                                                                std::string_view value) {
     static std::unordered_map<std::string, int> enums = {
         {"false", false},
         {"true", true},
@@ -387,7 +387,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::test_result(void* ctx, [[may
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::test_size(void* ctx, [[maybe_unused]] const void* args,
-                                                              const std::string& value) {
+                                                              std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     return context->parse_size(&context->test->offset, value, "size");
@@ -395,7 +395,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::test_size(void* ctx, [[maybe
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::test_value(void* ctx, [[maybe_unused]] const void* args,
-                                                               const std::string& value) {
+                                                               std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     return context->parse_hex(&context->test->value, value, "value");
@@ -403,7 +403,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::test_value(void* ctx, [[mayb
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::text_author(void* ctx, [[maybe_unused]] const void* args,
-                                                                const std::string& value) {
+                                                                std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     context->detector->author = value;
@@ -413,7 +413,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::text_author(void* ctx, [[may
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::text_name(void* ctx, [[maybe_unused]] const void* args,
-                                                              const std::string& value) {
+                                                              std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     context->detector->name = value;
@@ -423,7 +423,7 @@ XmlProcessor::CallbackStatus DetectorParserContext::text_name(void* ctx, [[maybe
 
 
 XmlProcessor::CallbackStatus DetectorParserContext::text_version(void* ctx, [[maybe_unused]] const void* args,
-                                                                 const std::string& value) {
+                                                                 std::string_view value) {
     auto context = static_cast<DetectorParserContext*>(ctx);
 
     context->detector->version = value;
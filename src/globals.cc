@@ -35,6 +35,6 @@
 
 Configuration configuration;
 
-Output output;
+thread_local Output output;
 
 StatusDBRun status_run;
\ No newline at end of file
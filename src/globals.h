@@ -40,7 +40,8 @@
 
 extern Configuration configuration;
 
-extern Output output;
+// Per thread, so worker threads can capture their messages.
+extern thread_local Output output;
 
 extern StatusDBRun status_run;
 
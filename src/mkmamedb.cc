@@ -47,10 +47,12 @@
 #include "Parser.h"
 #include "ParserDir.h"
 #include "ParserSourceFile.h"
+#include "OutputContextBuffer.h"
 #include "ParserSourceZip.h"
 #include "ProgramName.h"
 #include "RomDB.h"
 #include "globals.h"
+#include "parallel.h"
 #include "update_romdb.h"
 
 std::vector<Commandline::Option> mkmamedb_options = {
@@ -62,6 +64,7 @@ std::vector<Commandline::Option> mkmamedb_options = {
     Commandline::Option("hash-types", 'C', "types", "specify hash types to compute (default: all)", 1),
     Commandline::Option("list-available-dats", "list all dats found in dat-directories"),
     Commandline::Option("list-dats", "list dats used by current set"),
+    Commandline::Option("low-memory", "keep games in temporary database instead of memory", 1),
     Commandline::Option("no-directory-cache", "don't create cache of scanned input directory", 1),
     Commandline::Option("only-files", "pattern", "only use zip members matching shell glob pattern", 1),
     Commandline::Option("output", 'o', "dbfile", "write to database dbfile (default: mame.db)", 1),
@@ -72,7 +75,7 @@ std::vector<Commandline::Option> mkmamedb_options = {
     Commandline::Option("skip-files", "pattern", "don't use zip members matching shell glob pattern", 1)};
 
 std::unordered_set<std::string> mkmamedb_used_variables = {
-    "dats", "dat_directories", "mia_games", "roms_zipped", "use_description_as_name", "use_temp_directory"};
+    "dats", "dat_directories", "jobs", "mia_games", "roms_zipped", "use_description_as_name", "use_temp_directory"};
 
 #define DEFAULT_FILE_PATTERNS "*.dat"
 
@@ -138,6 +141,9 @@ void MkMameDB::global_setup(const ParsedCommandline& commandline) {
         else if (option.name == "list-dats") {
             list_dats = true;
         }
+        else if (option.name == "low-memory") {
+            low_memory = true;
+        }
         else if (option.name == "no-directory-cache") {
             cache_directory = false;
         }
@@ -231,6 +237,9 @@ bool MkMameDB::execute(const std::vector<std::string>& arguments) {
             exit(1);
         }
         out->add_header_overrides(header_overrides);
+        if (low_memory) {
+            out->use_staging_database();
+        }
 
         if (!detector_name.empty()) {
 #if defined(HAVE_LIBXML2)
@@ -247,12 +256,11 @@ bool MkMameDB::execute(const std::vector<std::string>& arguments) {
         // TODO: this isn't overridable by --only-files?
         file_patterns.emplace_back(DEFAULT_FILE_PATTERNS);
 
+        std::vector<Input> inputs;
         for (auto name : arguments) {
             if (name == "-") {
-                if (!process_stdin(out.get())) {
-                    out->error_occurred();
-                    ok = false;
-                }
+                inputs.emplace_back([this](OutputContext* output_context) { return process_stdin(output_context); },
+                                    false);
             }
             else {
                 auto last = name.find_last_not_of('/');
@@ -263,10 +271,41 @@ bool MkMameDB::execute(const std::vector<std::string>& arguments) {
                     name.resize(last + 1);
                 }
 
-                if (!process_file(name, out.get())) {
-                    out->error_occurred();
-                    ok = false;
-                }
+                add_inputs(name, inputs);
+            }
+        }
+
+        // Parse dats on worker threads first, they are added to the output in command line order below.
+        std::vector<size_t> parallel_inputs;
+        for (size_t index = 0; index < inputs.size(); index++) {
+            if (inputs[index].parallel) {
+                parallel_inputs.push_back(index);
+            }
+        }
+        std::vector<std::unique_ptr<OutputContextBuffer>> buffers(inputs.size());
+        // Buffering would keep all games of a dat in memory.
+        if (!low_memory && parallel_jobs(parallel_inputs.size()) > 1) {
+            for (auto index : parallel_inputs) {
+                buffers[index] = std::make_unique<OutputContextBuffer>();
+            }
+            parallel_for(parallel_inputs.size(), [&](size_t i) {
+                auto index = parallel_inputs[i];
+                buffers[index]->collect(inputs[index].process);
+            });
+        }
+
+        for (size_t index = 0; index < inputs.size(); index++) {
+            bool input_ok;
+            if (buffers[index]) {
+                input_ok = buffers[index]->replay(out.get());
+                buffers[index].reset();
+            }
+            else {
+                input_ok = inputs[index].process(out.get());
+            }
+            if (!input_ok) {
+                out->error_occurred();
+                ok = false;
             }
         }
 
@@ -286,30 +325,28 @@ bool MkMameDB::execute(const std::vector<std::string>& arguments) {
 bool MkMameDB::global_cleanup() { return true; }
 
 
-bool MkMameDB::process_file(const std::string& fname, OutputContext* out) {
+void MkMameDB::add_inputs(const std::string& fname, std::vector<Input>& inputs) {
     struct zip* za;
 
     try {
-        auto mdb = std::make_unique<RomDB>(fname, DBH_READ);
-        return mdb->export_db(exclude, out);
+        auto mdb = RomDB(fname, DBH_READ);
+        inputs.emplace_back([this, fname](OutputContext* out) { return process_romdb(fname, out); }, false);
+        return;
     }
     catch (std::exception& e) {
         /* that's fine */
     }
 
     if ((za = zip_open(fname.c_str(), 0, nullptr)) != nullptr) {
-        const char* name;
-        auto ok = true;
-
         for (uint64_t i = 0; i < static_cast<uint64_t>(zip_get_num_entries(za, 0)); i++) {
-            name = zip_get_name(za, i, 0);
+            std::string name = zip_get_name(za, i, 0);
 
             if (skip_files.find(name) != skip_files.end()) {
                 continue;
             }
             auto skip = true;
             for (auto& pattern : file_patterns) {
-                if (fnmatch(pattern.c_str(), name, 0) == 0) {
+                if (fnmatch(pattern.c_str(), name.c_str(), 0) == 0) {
                     skip = false;
                     break;
                 }
@@ -317,60 +354,67 @@ bool MkMameDB::process_file(const std::string& fname, OutputContext* out) {
             if (skip) {
                 continue;
             }
-            try {
-                auto ps = std::make_shared<ParserSourceZip>(fname, za, name);
-
-                if (!Parser::parse(ps, exclude, out, parser_options)) {
-                    ok = false;
-                }
-            }
-            catch (Exception& e) {
-                output.file_error("can't parse: {}", e.what());
-                ok = false;
-                continue;
-            }
+            inputs.emplace_back(
+                [this, fname, name](OutputContext* out) { return process_zip_member(fname, name, out); }, true);
         }
         zip_close(za);
+        return;
+    }
 
-        return ok;
+    std::error_code ec;
+    if (std::filesystem::is_directory(fname, ec)) {
+        inputs.emplace_back([this, fname](OutputContext* out) { return process_directory(fname, out); }, false);
+    }
+    else if (ec) {
+        inputs.emplace_back(
+            [fname, ec](OutputContext*) {
+                output.error("cannot stat() file '{}': {}", fname, ec.message());
+                return false;
+            },
+            false);
     }
     else {
-        ckmame_cache = std::make_shared<CkmameCache>();
+        inputs.emplace_back([this, fname](OutputContext* out) { return process_dat_file(fname, out); }, true);
+    }
+}
 
-        auto ok = true;
 
-        std::error_code ec;
-        if (std::filesystem::is_directory(fname, ec)) {
-            if (cache_directory) {
-                ckmame_cache->register_directory(fname, FILE_ROMSET);
-            }
+bool MkMameDB::process_dat_file(const std::string& fname, OutputContext* out) {
+    try {
+        auto ps = std::make_shared<ParserSourceFile>(fname);
+        return Parser::parse(ps, exclude, out, parser_options);
+    }
+    catch (std::exception& exception) {
+        output.error("can't process {}: {}", fname, exception.what());
+        return false;
+    }
+}
 
-            auto ctx = ParserDir(nullptr, exclude, out, parser_options, fname, hashtypes, flags & OUTPUT_FL_RUNTEST);
-            ok = ctx.parse();
-        }
-        else {
-            do {
-                if (ec) {
-                    output.error("cannot stat() file '{}': {}", fname, ec.message());
-                    ok = false;
-                    break;
-                }
 
-                try {
-                    auto ps = std::make_shared<ParserSourceFile>(fname);
-                    ok = Parser::parse(ps, exclude, out, parser_options);
-                }
-                catch (std::exception& exception) {
-                    std::cerr << ProgramName::get() << ": can't process " << fname << ": " << exception.what()
-                              << std::endl;
-                    ok = false;
-                }
-            } while (false);
-        }
+bool MkMameDB::process_directory(const std::string& fname, OutputContext* out) {
+    ckmame_cache = std::make_shared<CkmameCache>();
 
-        ckmame_cache = nullptr;
+    if (cache_directory) {
+        ckmame_cache->register_directory(fname, FILE_ROMSET);
+    }
+
+    auto ctx = ParserDir(nullptr, exclude, out, parser_options, fname, hashtypes, flags & OUTPUT_FL_RUNTEST);
+    auto ok = ctx.parse();
+
+    ckmame_cache = nullptr;
 
-        return ok;
+    return ok;
+}
+
+
+bool MkMameDB::process_romdb(const std::string& fname, OutputContext* out) {
+    try {
+        auto mdb = std::make_unique<RomDB>(fname, DBH_READ);
+        return mdb->export_db(exclude, out);
+    }
+    catch (std::exception& exception) {
+        output.error("can't process {}: {}", fname, exception.what());
+        return false;
     }
 }
 
@@ -386,3 +430,27 @@ bool MkMameDB::process_stdin(OutputContext* out) {
         return false;
     }
 }
+
+
+bool MkMameDB::process_zip_member(const std::string& archive_name, const std::string& name, OutputContext* out) {
+    // Each member opens the archive itself, so members can be parsed on different threads.
+    struct zip* za;
+    if ((za = zip_open(archive_name.c_str(), 0, nullptr)) == nullptr) {
+        output.error("can't open '{}'", archive_name);
+        return false;
+    }
+
+    auto ok = true;
+    try {
+        auto ps = std::make_shared<ParserSourceZip>(archive_name, za, name);
+
+        ok = Parser::parse(ps, exclude, out, parser_options);
+    }
+    catch (Exception& e) {
+        output.file_error("can't parse: {}", e.what());
+        ok = false;
+    }
+    zip_close(za);
+
+    return ok;
+}
@@ -0,0 +1,60 @@
+#ifndef HAD_PARALLEL_H
+#define HAD_PARALLEL_H
+
+/*
+  parallel.h -- run independent work items on multiple threads
+  Copyright (C) 2026 Dieter Baron and Thomas Klausner
+
+  This file is part of ckmame, a program to check rom sets for MAME.
+  The authors can be contacted at <ckmame@nih.at>
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+  1. Redistributions of source code must retain the above copyright
+     notice, this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright
+     notice, this list of conditions and the following disclaimer in
+     the documentation and/or other materials provided with the
+     distribution.
+  3. The name of the author may not be used to endorse or promote
+     products derived from this software without specific prior
+     written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS
+  OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY
+  DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+  IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Get the number of threads to use for `count` work items, as limited by the `jobs` configuration setting.
+ *
+ * @param count The number of work items.
+ * @return The number of threads to use, at least 1.
+ */
+size_t parallel_jobs(size_t count);
+
+/**
+ * Call `function` for each index in [0, `count`), using up to `parallel_jobs(count)` threads.
+ *
+ * Work items are handed out in index order, but may complete in any order. `function` must only modify state
+ * belonging to its own index. If a call throws, the remaining items are still processed; afterwards, the exception of
+ * the lowest failed index is rethrown in the calling thread.
+ *
+ * @param count The number of work items.
+ * @param function The function to call for each index.
+ */
+void parallel_for(size_t count, const std::function<void(size_t)>& function);
+
+#endif // HAD_PARALLEL_H
@@ -35,26 +35,32 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+
 #include "DatRepository.h"
 #include "Exception.h"
 #include "OutputContext.h"
+#include "OutputContextBuffer.h"
 #include "OutputContextDb.h"
 #include "Parser.h"
 #include "ParserSourceFile.h"
 #include "ParserSourceZip.h"
 #include "RomDB.h"
+#include "RomDBSnapshot.h"
 #include "file_util.h"
 #include "globals.h"
+#include "parallel.h"
 
 
 /**
  * Check if RomDB is up to date with the dats in the dat directories.
  *
  * @param dats_to_use Output parameter, list of dats to use to update RomDB.
+ * @param changed_dats Output parameter, for each entry in `dats_to_use` whether it is new or changed.
  * @return true if RomDB is up to date, false if newer dats are available.
  * @throw Exception if there is an error accessing the database or dat files or a dat can't be found.
  */
-static bool is_romdb_up_to_date(std::vector<DatDB::DatInfo>& dats_to_use) {
+static bool is_romdb_up_to_date(std::vector<DatDB::DatInfo>& dats_to_use, std::vector<bool>& changed_dats) {
     auto repository = DatRepository(configuration.dat_directories);
 
     auto up_to_date = true;
@@ -84,6 +90,7 @@ static bool is_romdb_up_to_date(std::vector<DatDB::DatInfo>& dats_to_use) {
 
         dats_to_use.push_back(fs_dat);
         fs_dat_names.insert(dat_name);
+        changed_dats.push_back(true);
 
         if (it == db_dats.end()) {
             output.message("{} (-> {})", dat_name, fs_dat.version);
@@ -100,6 +107,14 @@ static bool is_romdb_up_to_date(std::vector<DatDB::DatInfo>& dats_to_use) {
             output.message("{} ({}: {:08x} -> {:08x})", dat_name, db_dat->version, db_dat->crc, fs_dat.crc);
             up_to_date = false;
         }
+        else if (fs_dat.version == db_dat->version && DatOptions(dat_name).checksum() != db_dat->options) {
+            // Games are added as parsed with these options (including the MIA list), so the dat must be parsed again.
+            output.message("{} ({}: options changed)", dat_name, db_dat->version);
+            up_to_date = false;
+        }
+        else if (fs_dat.version == db_dat->version) {
+            changed_dats.back() = false;
+        }
     }
 
     for (const auto& db_dat : db_dat_list) {
@@ -112,17 +127,152 @@ static bool is_romdb_up_to_date(std::vector<DatDB::DatInfo>& dats_to_use) {
 }
 
 
+/**
+ * Check whether RomDB can be updated in place, keeping the games of unchanged dats.
+ *
+ * This is only possible if the dats are the same as in RomDB and in the same order. Also, since renaming duplicate
+ * games depends on all dats, no games may have been renamed.
+ *
+ * @param dats_to_use List of dats to use to update RomDB.
+ * @param changed_dats For each entry in `dats_to_use` whether it is new or changed.
+ * @param db_dats Output parameter, dat entries from RomDB.
+ * @return true if RomDB can be updated in place.
+ */
+static bool can_update_incrementally(const std::vector<DatDB::DatInfo>& dats_to_use,
+                                     const std::vector<bool>& changed_dats, std::vector<DatEntry>& db_dats) {
+    if (std::find(changed_dats.begin(), changed_dats.end(), false) == changed_dats.end()) {
+        return false;
+    }
+
+    std::vector<std::string> game_names;
+
+    try {
+        auto existing_db = RomDB(configuration.rom_db, DBH_READ);
+        if (existing_db.has_detector()) {
+            return false;
+        }
+        db_dats = existing_db.read_dat();
+        game_names = existing_db.read_list(DBH_KEY_LIST_GAME);
+    }
+    catch (...) {
+        return false;
+    }
+
+    if (db_dats.size() != dats_to_use.size()) {
+        return false;
+    }
+    for (size_t dat_idx = 0; dat_idx < dats_to_use.size(); dat_idx++) {
+        const auto& name = dats_to_use[dat_idx].name;
+        if (db_dats[dat_idx].name != name) {
+            return false;
+        }
+        if (configuration.dat_suffix_only_duplicates(name) && !configuration.dat_game_name_suffix(name).empty()) {
+            return false;
+        }
+    }
+
+    // Duplicates are renamed to "name (n)".
+    auto names = std::unordered_set<std::string>(game_names.begin(), game_names.end());
+    for (const auto& name : game_names) {
+        if (name.empty() || name.back() != ')') {
+            continue;
+        }
+        auto open = name.rfind(" (");
+        if (open == std::string::npos || open + 3 >= name.size()) {
+            continue;
+        }
+        if (std::all_of(name.begin() + static_cast<std::string::difference_type>(open) + 2, name.end() - 1,
+                        [](char c) { return isdigit(static_cast<unsigned char>(c)); }) &&
+            names.contains(name.substr(0, open))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Add the games of an unchanged dat from the RomDB being updated, instead of parsing the dat again.
+ *
+ * Fields computed from other games are reset, so they are recomputed like for a parsed dat.
+ */
+static void add_unchanged_dat(OutputContextDb* output_context, size_t dat_idx, const DatDB::DatInfo& dat,
+                              const DatEntry& db_dat) {
+    auto file_info =
+        dat.entry_name.empty() ? Output::FileInfo(dat.file_name) : Output::FileInfo(dat.file_name, dat.entry_name);
+    output_context->start_dat(DatOptions(dat.name), file_info);
+    output_context->add_header(db_dat);
+
+    for (const auto& base_game : output_context->get_base_games()) {
+        if (base_game.dat_no != dat_idx) {
+            continue;
+        }
+        auto game = std::make_shared<Game>(base_game);
+        game->original_name = game->name;
+        game->cloneof[1] = "";
+        for (auto& files : game->files) {
+            for (auto& file : files) {
+                file.where = FILE_INGAME;
+            }
+        }
+        output_context->add_game(game);
+    }
+}
+
+
+/**
+ * Parse a dat from the dat directories.
+ *
+ * @param dat The dat to parse.
+ * @param output_context The output context to add the dat to.
+ * @throw Exception if the dat can't be opened or parsed.
+ */
+static void parse_dat(const DatDB::DatInfo& dat, OutputContext* output_context) {
+    ParserSourcePtr source;
+
+    if (dat.entry_name.empty()) {
+        source = std::make_shared<ParserSourceFile>(dat.file_name);
+    }
+    else {
+        int error_code;
+        auto zip_archive = zip_open(dat.file_name.c_str(), 0, &error_code);
+        if (zip_archive == nullptr) {
+            zip_error_t error;
+            zip_error_init_with_code(&error, error_code);
+            auto message = "can't open '" + dat.file_name + "': " + zip_error_strerror(&error);
+            zip_error_fini(&error);
+            throw Exception(message);
+        }
+        source = std::make_shared<ParserSourceZip>(dat.file_name, zip_archive, dat.entry_name);
+    }
+
+    auto options = DatOptions(dat.name);
+    if (!Parser::parse(source, {}, output_context, options)) {
+        auto message = "can't parse '" + dat.file_name + "'";
+        if (!dat.entry_name.empty()) {
+            message += "/" + dat.entry_name;
+        }
+        throw Exception(message);
+    }
+}
+
+
 bool update_romdb(bool force) {
     if (configuration.dats.empty() || configuration.dat_directories.empty()) {
         return false;
     }
 
     std::vector<DatDB::DatInfo> dats_to_use;
+    std::vector<bool> changed_dats;
 
-    if (is_romdb_up_to_date(dats_to_use) && !force) {
+    if (is_romdb_up_to_date(dats_to_use, changed_dats) && !force) {
         return false;
     }
 
+    std::vector<DatEntry> db_dats;
+    auto incremental = !force && can_update_incrementally(dats_to_use, changed_dats, db_dats);
+
     OutputContextPtr output;
 
     try {
@@ -130,36 +280,47 @@ bool update_romdb(bool force) {
         if (!configuration.use_temp_directory) {
             filename = make_unique_path(filename);
         }
-        output = OutputContext::create(OutputContext::FORMAT_DB, filename);
-        // auto new_db = dynamic_cast<OutputContextDb*>(output.get())->get_db();
+        std::shared_ptr<OutputContextDb> update_output;
+        if (incremental) {
+            update_output = std::make_shared<OutputContextDb>(filename, configuration.rom_db);
+            output = update_output;
+        }
+        else {
+            output = OutputContext::create(OutputContext::FORMAT_DB, filename);
+        }
+
+        // Parse dats on worker threads first, they are added to the output in dat order below.
+        std::vector<size_t> dats_to_parse;
+        for (size_t dat_idx = 0; dat_idx < dats_to_use.size(); dat_idx++) {
+            if (!update_output || changed_dats[dat_idx]) {
+                dats_to_parse.push_back(dat_idx);
+            }
+        }
+        std::vector<std::unique_ptr<OutputContextBuffer>> buffers(dats_to_use.size());
+        if (parallel_jobs(dats_to_parse.size()) > 1) {
+            for (auto dat_idx : dats_to_parse) {
+                buffers[dat_idx] = std::make_unique<OutputContextBuffer>();
+            }
+            parallel_for(dats_to_parse.size(), [&](size_t index) {
+                auto dat_idx = dats_to_parse[index];
+                buffers[dat_idx]->collect([&](OutputContext* buffer) {
+                    parse_dat(dats_to_use[dat_idx], buffer);
+                    return true;
+                });
+            });
+        }
 
         size_t dat_idx = 0;
         for (const auto& dat : dats_to_use) {
-            ParserSourcePtr source;
-
-            if (dat.entry_name.empty()) {
-                source = std::make_shared<ParserSourceFile>(dat.file_name);
+            if (update_output && !changed_dats[dat_idx]) {
+                add_unchanged_dat(update_output.get(), dat_idx, dat, db_dats[dat_idx]);
             }
-            else {
-                int error_code;
-                auto zip_archive = zip_open(dat.file_name.c_str(), 0, &error_code);
-                if (zip_archive == nullptr) {
-                    zip_error_t error;
-                    zip_error_init_with_code(&error, error_code);
-                    auto message = "can't open '" + dat.file_name + "': " + zip_error_strerror(&error);
-                    zip_error_fini(&error);
-                    throw Exception(message);
-                }
-                source = std::make_shared<ParserSourceZip>(dat.file_name, zip_archive, dat.entry_name);
+            else if (buffers[dat_idx]) {
+                buffers[dat_idx]->replay(output.get());
+                buffers[dat_idx].reset();
             }
-
-            auto options = DatOptions(dat.name);
-            if (!Parser::parse(source, {}, output.get(), options)) {
-                auto message = "can't parse '" + dat.file_name + "'";
-                if (!dat.entry_name.empty()) {
-                    message += "/" + dat.entry_name;
-                }
-                throw Exception(message);
+            else {
+                parse_dat(dat, output.get());
             }
 
             // This no longer works this way, and should not be neccessary, since the mkmamedb already flags empty dats.
@@ -180,6 +341,7 @@ bool update_romdb(bool force) {
         }
         if (!configuration.use_temp_directory) {
             std::filesystem::rename(filename, configuration.rom_db);
+            RomDBSnapshot::rename(filename, configuration.rom_db);
         }
     }
     catch (std::exception& ex) {
@@ -80,12 +80,12 @@ std::string bin2hex(const std::vector<uint8_t>& bin) {
     (((c) >= '0' && (c) <= '9') ? (c) - '0' : ((c) >= 'A' && (c) <= 'F') ? (c) - 'A' + 10 : (c) - 'a' + 10)
 
 
-std::vector<uint8_t> hex2bin(const std::string& hex) {
+std::vector<uint8_t> hex2bin(std::string_view hex) {
     if (hex.size() % 2 != 0) {
         throw Exception("hex string with odd number of digits");
     }
 
-    if (hex.find_first_not_of("0123456789AaBbCcDdEeFf") != std::string::npos) {
+    if (hex.find_first_not_of("0123456789AaBbCcDdEeFf") != std::string_view::npos) {
         throw Exception("hex string with invalid digit");
     }
 
@@ -36,6 +36,7 @@
 
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <cstdarg>
@@ -47,7 +48,7 @@ enum name_type { NAME_ZIP, NAME_IMAGES, NAME_IGNORE, NAME_UNKNOWN };
 
 typedef enum name_type name_type_t;
 
-std::vector<uint8_t> hex2bin(const std::string& hex);
+std::vector<uint8_t> hex2bin(std::string_view hex);
 std::string bin2hex(const std::vector<uint8_t>& bin);
 bool string_less_case_insensitive(const std::string& lhs, const std::string& rhs);
 std::string string_lower(const std::string& s);